@@ -0,0 +1,176 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "kite-anchor-selector.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <limits>
+#include <sstream>
+
+NS_LOG_COMPONENT_DEFINE("ndn.kite.KiteAnchorSelector");
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief An anchor has to be this much closer than the selected one to take over
+ */
+static const double SWITCH_THRESHOLD = 0.9;
+
+/**
+ * @brief Number of consecutive lost probes after which an anchor is considered unreachable
+ */
+static const uint32_t MAX_LOSSES = 3;
+
+KiteAnchorSelector::KiteAnchorSelector()
+  : m_probeSeq(0)
+  , m_selected(std::numeric_limits<size_t>::max())
+{
+}
+
+void
+KiteAnchorSelector::SetAnchors(const std::string& anchors)
+{
+  m_anchors.clear();
+  m_probes.clear();
+  m_selected = std::numeric_limits<size_t>::max();
+
+  std::istringstream is(anchors);
+  std::string prefix;
+  while (is >> prefix) {
+    AnchorState anchor;
+    anchor.prefix = Name(prefix);
+    anchor.losses = 0;
+    m_anchors.push_back(anchor);
+  }
+}
+
+Name
+KiteAnchorSelector::MakeProbeName(size_t index)
+{
+  Name probeName(m_anchors[index].prefix);
+  probeName.append("probe").appendSequenceNumber(m_probeSeq++);
+
+  m_probes[probeName] = std::make_pair(index, Simulator::Now());
+  return probeName;
+}
+
+bool
+KiteAnchorSelector::OnProbeData(const Name& dataName)
+{
+  auto probe = m_probes.find(dataName);
+  if (probe == m_probes.end())
+    return false;
+
+  AnchorState& anchor = m_anchors[probe->second.first];
+  Time sample = Simulator::Now() - probe->second.second;
+  m_probes.erase(probe);
+
+  anchor.losses = 0;
+  if (anchor.srtt.IsZero()) {
+    anchor.srtt = sample;
+  }
+  else {
+    anchor.srtt = (anchor.srtt * 7 + sample) / 8;
+  }
+
+  NS_LOG_DEBUG("RTT to anchor " << anchor.prefix << ": " << sample.GetMilliSeconds() << "ms, smoothed "
+               << anchor.srtt.GetMilliSeconds() << "ms");
+  return true;
+}
+
+void
+KiteAnchorSelector::ExpireProbes(Time lifetime)
+{
+  Time now = Simulator::Now();
+  for (auto probe = m_probes.begin(); probe != m_probes.end();) {
+    if (probe->second.second + lifetime <= now) {
+      m_anchors[probe->second.first].losses++;
+      probe = m_probes.erase(probe);
+    }
+    else {
+      ++probe;
+    }
+  }
+}
+
+bool
+KiteAnchorSelector::Reselect()
+{
+  size_t best = std::numeric_limits<size_t>::max();
+  for (size_t i = 0; i < m_anchors.size(); i++) {
+    const AnchorState& anchor = m_anchors[i];
+    if (anchor.srtt.IsZero() || anchor.losses >= MAX_LOSSES)
+      continue;
+
+    if (best == std::numeric_limits<size_t>::max() || anchor.srtt < m_anchors[best].srtt) {
+      best = i;
+    }
+  }
+
+  if (best == std::numeric_limits<size_t>::max() || best == m_selected)
+    return false;
+
+  if (HasSelection() && m_anchors[m_selected].losses < MAX_LOSSES
+      && m_anchors[best].srtt.GetSeconds() > m_anchors[m_selected].srtt.GetSeconds() * SWITCH_THRESHOLD) {
+    return false; // not worth moving the trace
+  }
+
+  NS_LOG_INFO("Selecting anchor " << m_anchors[best].prefix << " (RTT "
+              << m_anchors[best].srtt.GetMilliSeconds() << "ms)");
+  m_selected = best;
+  return true;
+}
+
+Name
+KiteAnchorSelector::MakeAnchorUpdateName(const Name& serverPrefix, const Name& anchor, const Name& traceName,
+                                         uint32_t seq)
+{
+  Name updateName(serverPrefix);
+  updateName.append("kite-anchor").appendNumber(anchor.size()).append(traceName).appendSequenceNumber(seq);
+  return updateName;
+}
+
+bool
+KiteAnchorSelector::ParseAnchorUpdate(const Name& updateName, const Name& serverPrefix, Name& anchor,
+                                      Name& traceName)
+{
+  if (!serverPrefix.isPrefixOf(updateName) || updateName.empty() || !updateName.get(-1).isSequenceNumber())
+    return false;
+
+  // the update may be sent under any name the server answers
+  size_t marker = serverPrefix.size();
+  while (marker < updateName.size() && updateName.get(marker) != ::ndn::name::Component("kite-anchor")) {
+    marker++;
+  }
+  if (marker + 3 > updateName.size() || !updateName.get(marker + 1).isNumber())
+    return false;
+
+  traceName = updateName.getSubName(marker + 2, updateName.size() - marker - 3);
+  uint64_t anchorSize = updateName.get(marker + 1).toNumber();
+  if (anchorSize == 0 || anchorSize > traceName.size())
+    return false;
+
+  anchor = traceName.getPrefix(anchorSize);
+  return true;
+}
+
+} // namespace ndn
+} // namespace ns3
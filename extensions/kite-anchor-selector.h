@@ -0,0 +1,142 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NDN_KITE_ANCHOR_SELECTOR_H
+#define NDN_KITE_ANCHOR_SELECTOR_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "ns3/nstime.h"
+
+#include <map>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-apps
+ * @brief Keeps track of the round-trip time to a set of anchors and picks the closest one
+ *
+ * Used by mobile applications that may attach their trace to any of several anchors.
+ * Each anchor is probed with plain Interests named <anchor>/probe/<seq>, answered by a Producer
+ * installed on the anchor node.  The anchor with the lowest smoothed RTT is selected,
+ * with some hysteresis so that the trace does not flap between anchors at similar distance.
+ *
+ * Servers learn the selected anchor from anchor updates named
+ * <server>/kite-anchor/<number of anchor components>/<trace name>/<seq>,
+ * where <server> is any name under the prefix of the server application.
+ */
+class KiteAnchorSelector {
+public:
+  KiteAnchorSelector();
+
+  /**
+   * @brief Set the anchors from a whitespace separated list of prefixes
+   */
+  void
+  SetAnchors(const std::string& anchors);
+
+  size_t
+  GetAnchorCount() const
+  {
+    return m_anchors.size();
+  }
+
+  const Name&
+  GetAnchor(size_t index) const
+  {
+    return m_anchors[index].prefix;
+  }
+
+  /**
+   * @brief Name of the next probe to the given anchor, remembering its send time
+   */
+  Name
+  MakeProbeName(size_t index);
+
+  /**
+   * @brief Account for a Data packet answering a probe
+   * @returns false if the Data does not answer a probe
+   */
+  bool
+  OnProbeData(const Name& dataName);
+
+  /**
+   * @brief Forget probes older than the given lifetime, counting them as losses
+   */
+  void
+  ExpireProbes(Time lifetime);
+
+  /**
+   * @brief Select the anchor to attach the trace to
+   * @returns true if the selection changed
+   */
+  bool
+  Reselect();
+
+  bool
+  HasSelection() const
+  {
+    return m_selected < m_anchors.size();
+  }
+
+  const Name&
+  GetSelectedAnchor() const
+  {
+    return m_anchors[m_selected].prefix;
+  }
+
+  Time
+  GetRtt(size_t index) const
+  {
+    return m_anchors[index].srtt;
+  }
+
+  /**
+   * @brief Name of an update telling a server that the trace now goes through the given anchor
+   */
+  static Name
+  MakeAnchorUpdateName(const Name& serverPrefix, const Name& anchor, const Name& traceName, uint32_t seq);
+
+  /**
+   * @brief Extract anchor and trace name from an anchor update
+   * @returns false if the Interest is not an anchor update for this server
+   */
+  static bool
+  ParseAnchorUpdate(const Name& updateName, const Name& serverPrefix, Name& anchor, Name& traceName);
+
+private:
+  struct AnchorState
+  {
+    Name prefix;
+    Time srtt;        ///< @brief zero until the first answer
+    uint32_t losses;  ///< @brief consecutive unanswered probes
+  };
+
+  std::vector<AnchorState> m_anchors;
+  std::map<Name, std::pair<size_t, Time>> m_probes; ///< @brief outstanding probes -> anchor and send time
+  uint32_t m_probeSeq;
+  size_t m_selected;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_KITE_ANCHOR_SELECTOR_H
@@ -0,0 +1,189 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "kite-background-traffic.h"
+#include "kite-topology.h"
+
+#include "ns3/log.h"
+#include "ns3/string.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+
+#include "helper/ndn-app-helper.hpp"
+#include "helper/ndn-fib-helper.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+NS_LOG_COMPONENT_DEFINE("ndn.kite.KiteBackgroundTraffic");
+
+namespace ns3 {
+namespace ndn {
+
+const uint32_t KiteBackgroundTraffic::DATA_OVERHEAD = 50;
+
+KiteBackgroundTraffic::KiteBackgroundTraffic()
+  : m_prefix("/background")
+  , m_load(0.5)
+  , m_payloadSize(1024)
+  , m_bursty(false)
+  , m_pairs(0)
+{
+}
+
+void
+KiteBackgroundTraffic::SetPrefix(const std::string& prefix)
+{
+  m_prefix = prefix;
+}
+
+void
+KiteBackgroundTraffic::SetLoad(double load)
+{
+  m_load = load;
+}
+
+void
+KiteBackgroundTraffic::SetPayloadSize(uint32_t payloadSize)
+{
+  m_payloadSize = payloadSize;
+}
+
+void
+KiteBackgroundTraffic::SetBursty(Time meanOn, Time meanOff)
+{
+  m_bursty = true;
+  m_meanOn = meanOn;
+  m_meanOff = meanOff;
+}
+
+double
+KiteBackgroundTraffic::GetFrequency(const std::vector<Ptr<Node>>& path, const LinkUsage& usage) const
+{
+  // the busiest link of the path, relative to its capacity, sets the rate of the pair
+  double bitRate = -1;
+  for (size_t hop = 0; hop + 1 < path.size(); hop++) {
+    Link link(path[hop + 1]->GetId(), path[hop]->GetId());
+    auto sharers = usage.find(link);
+    double share = KiteTopology::GetLinkRate(path[hop + 1], path[hop]).GetBitRate()
+                   / (sharers != usage.end() ? sharers->second : 1);
+    if (bitRate < 0 || share < bitRate) {
+      bitRate = share;
+    }
+  }
+
+  double frequency = m_load * std::max(bitRate, 0.0) / (8.0 * (m_payloadSize + DATA_OVERHEAD));
+  if (m_bursty) {
+    frequency *= (m_meanOn + m_meanOff).GetSeconds() / m_meanOn.GetSeconds();
+  }
+  return frequency;
+}
+
+ApplicationContainer
+KiteBackgroundTraffic::Install(Ptr<Node> consumer, Ptr<Node> producer)
+{
+  // wireless links are never on the path: the range of 0 leaves only point-to-point neighbors
+  std::vector<Ptr<Node>> path = KiteTopology::GetShortestPath(consumer, producer, 0.0);
+  if (path.size() < 2) {
+    NS_LOG_WARN("No point-to-point path from node " << consumer->GetId() << " to node " << producer->GetId());
+    return ApplicationContainer();
+  }
+
+  return InstallPath(path, LinkUsage());
+}
+
+ApplicationContainer
+KiteBackgroundTraffic::InstallPath(const std::vector<Ptr<Node>>& path, const LinkUsage& usage)
+{
+  ApplicationContainer apps;
+  Ptr<Node> consumer = path.front();
+  Ptr<Node> producer = path.back();
+  double frequency = GetFrequency(path, usage);
+
+  std::string prefix = m_prefix + "/" + std::to_string(m_pairs++);
+  for (size_t hop = 0; hop + 1 < path.size(); hop++) {
+    FibHelper::AddRoute(path[hop], prefix, path[hop + 1], 1);
+  }
+
+  AppHelper producerHelper("ns3::ndn::Producer");
+  producerHelper.SetPrefix(prefix);
+  producerHelper.SetAttribute("PayloadSize", UintegerValue(m_payloadSize));
+  apps.Add(producerHelper.Install(producer));
+
+  AppHelper consumerHelper(m_bursty ? "ns3::ndn::KiteOnOffConsumer" : "ns3::ndn::ConsumerCbr");
+  consumerHelper.SetPrefix(prefix);
+  consumerHelper.SetAttribute("Frequency", DoubleValue(frequency));
+  if (m_bursty) {
+    std::stringstream onTime;
+    onTime << "ns3::ExponentialRandomVariable[Mean=" << m_meanOn.GetSeconds() << "]";
+    std::stringstream offTime;
+    offTime << "ns3::ExponentialRandomVariable[Mean=" << m_meanOff.GetSeconds() << "]";
+    consumerHelper.SetAttribute("OnTime", StringValue(onTime.str()));
+    consumerHelper.SetAttribute("OffTime", StringValue(offTime.str()));
+  }
+  apps.Add(consumerHelper.Install(consumer));
+
+  NS_LOG_INFO("Background pair " << prefix << " from node " << consumer->GetId() << " to node "
+              << producer->GetId() << ", " << (path.size() - 1) << " hops, " << frequency << " Interests/s");
+  return apps;
+}
+
+ApplicationContainer
+KiteBackgroundTraffic::InstallAcross(const NodeContainer& nodes, uint32_t pairs)
+{
+  ApplicationContainer apps;
+  if (nodes.GetN() < 2)
+    return apps;
+
+  // find all paths first, so that every pair knows how many others share its links
+  std::vector<std::vector<Ptr<Node>>> paths;
+  LinkUsage usage;
+  for (uint32_t pair = 0; pair < pairs; pair++) {
+    Ptr<Node> consumer = nodes.Get(pair % nodes.GetN());
+
+    Ptr<Node> producer;
+    int farthest = 0;
+    for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); node++) {
+      int hops = KiteTopology::GetHopCount(consumer, *node, 0.0);
+      if (hops > farthest) {
+        farthest = hops;
+        producer = *node;
+      }
+    }
+    if (producer == 0)
+      continue;
+
+    std::vector<Ptr<Node>> path = KiteTopology::GetShortestPath(consumer, producer, 0.0);
+    if (path.size() < 2)
+      continue;
+
+    for (size_t hop = 0; hop + 1 < path.size(); hop++) {
+      usage[Link(path[hop + 1]->GetId(), path[hop]->GetId())]++;
+    }
+    paths.push_back(path);
+  }
+
+  for (const auto& path : paths) {
+    apps.Add(InstallPath(path, usage));
+  }
+  return apps;
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,115 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NDN_KITE_BACKGROUND_TRAFFIC_H
+#define NDN_KITE_BACKGROUND_TRAFFIC_H
+
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/application-container.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Installs consumer/producer pairs loading the point-to-point backbone of a scenario
+ *
+ * Every pair is a Producer answering <prefix>/<pair> and a consumer fetching from it, with routes
+ * added along a shortest path of point-to-point links (see KiteTopology).  The consumer is a ConsumerCbr,
+ * or a KiteOnOffConsumer in bursty mode.  Pairs installed together split the capacity of the links they share,
+ * so that on average their Data occupy at most the requested share of the DataRate of every link.
+ */
+class KiteBackgroundTraffic {
+public:
+  KiteBackgroundTraffic();
+
+  void
+  SetPrefix(const std::string& prefix);
+
+  /**
+   * @brief Share of the capacity of every link the pairs may use together, e.g. 0.7
+   */
+  void
+  SetLoad(double load);
+
+  void
+  SetPayloadSize(uint32_t payloadSize);
+
+  /**
+   * @brief Alternate exponentially distributed sending and silent periods with the given means
+   *
+   * During sending periods the rate is raised so that the average load stays the same.
+   */
+  void
+  SetBursty(Time meanOn, Time meanOff);
+
+  /**
+   * @brief Install one pair, returns the consumer and the producer
+   */
+  ApplicationContainer
+  Install(Ptr<Node> consumer, Ptr<Node> producer);
+
+  /**
+   * @brief Install pairs between the given nodes, pair i from node i (modulo their number) to the node farthest from it
+   */
+  ApplicationContainer
+  InstallAcross(const NodeContainer& nodes, uint32_t pairs);
+
+private:
+  typedef std::pair<uint32_t, uint32_t> Link; ///< @brief node ids, in the direction of the Data
+  typedef std::map<Link, uint32_t> LinkUsage; ///< @brief number of pairs sending Data over a link
+
+  /**
+   * @brief Install the pair along the given path, from the consumer to the producer
+   */
+  ApplicationContainer
+  InstallPath(const std::vector<Ptr<Node>>& path, const LinkUsage& usage);
+
+  /**
+   * @brief Interests per second of the consumer of path while it is sending, so that no link of path
+   * goes over the load with the pairs sharing it
+   */
+  double
+  GetFrequency(const std::vector<Ptr<Node>>& path, const LinkUsage& usage) const;
+
+  /**
+   * @brief Bytes a Data carries besides its payload on a link: name, signature, link protocol and PPP headers
+   */
+  static const uint32_t DATA_OVERHEAD;
+
+  std::string m_prefix;
+  double m_load;
+  uint32_t m_payloadSize;
+  bool m_bursty;
+  Time m_meanOn;
+  Time m_meanOff;
+  uint32_t m_pairs;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_KITE_BACKGROUND_TRAFFIC_H
@@ -0,0 +1,206 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "kite-delay-tracer.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/node-list.h"
+#include "ns3/names.h"
+#include "ns3/callback.h"
+
+#include "ns3/ndnSIM/apps/ndn-app.hpp"
+#include "ns3/ndnSIM/apps/ndn-consumer.hpp"
+
+#include <boost/lexical_cast.hpp>
+
+#include <list>
+#include <tuple>
+
+NS_LOG_COMPONENT_DEFINE("ndn.kite.KiteDelayTracer");
+
+namespace ns3 {
+namespace ndn {
+
+static std::list<std::tuple<shared_ptr<std::ostream>, std::list<Ptr<KiteDelayTracer>>>> g_tracers;
+
+void
+KiteDelayTracer::Destroy()
+{
+  g_tracers.clear();
+}
+
+void
+KiteDelayTracer::InstallAll(const std::string& file, Time period)
+{
+  NodeContainer nodes;
+  for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
+    nodes.Add(*node);
+  }
+
+  Install(nodes, file, period);
+}
+
+void
+KiteDelayTracer::Install(const NodeContainer& nodes, const std::string& file, Time period)
+{
+  std::list<Ptr<KiteDelayTracer>> tracers;
+  shared_ptr<std::ostream> outputStream;
+  if (file != "-") {
+    shared_ptr<std::ofstream> os(new std::ofstream());
+    os->open(file.c_str(), std::ios_base::out | std::ios_base::trunc);
+
+    if (!os->is_open()) {
+      NS_LOG_ERROR("File " << file << " cannot be opened for writing. Tracing disabled");
+      return;
+    }
+
+    outputStream = os;
+  }
+  else {
+    outputStream = shared_ptr<std::ostream>(&std::cout, std::bind([]{}));
+  }
+
+  for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); node++) {
+    Ptr<KiteDelayTracer> trace = Create<KiteDelayTracer>(outputStream, *node);
+    trace->SetPeriod(period);
+    tracers.push_back(trace);
+  }
+
+  if (tracers.size() > 0) {
+    tracers.front()->PrintHeader(*outputStream);
+    *outputStream << "\n";
+  }
+
+  if (g_tracers.empty()) {
+    Simulator::ScheduleDestroy(&KiteDelayTracer::Destroy);
+  }
+  g_tracers.push_back(std::make_tuple(outputStream, tracers));
+}
+
+KiteDelayTracer::KiteDelayTracer(shared_ptr<std::ostream> os, Ptr<Node> node)
+  : m_os(os)
+  , m_nodePtr(node)
+{
+  m_node = boost::lexical_cast<std::string>(m_nodePtr->GetId());
+
+  std::string name = Names::FindName(node);
+  if (!name.empty()) {
+    m_node = name;
+  }
+
+  for (uint32_t i = 0; i < node->GetNApplications(); i++) {
+    Ptr<Consumer> consumer = DynamicCast<Consumer>(node->GetApplication(i));
+    if (consumer == 0)
+      continue;
+
+    consumer->TraceConnectWithoutContext("LastRetransmittedInterestDataDelay",
+                                         MakeCallback(&KiteDelayTracer::LastRetransmittedInterestDataDelay, this));
+    consumer->TraceConnectWithoutContext("FirstInterestDataDelay",
+                                         MakeCallback(&KiteDelayTracer::FirstInterestDataDelay, this));
+  }
+}
+
+KiteDelayTracer::~KiteDelayTracer()
+{
+  m_printEvent.Cancel();
+}
+
+void
+KiteDelayTracer::SetPeriod(const Time& period)
+{
+  m_period = period;
+  m_printEvent.Cancel();
+  if (m_period != Time(0)) {
+    m_printEvent = Simulator::Schedule(m_period, &KiteDelayTracer::PeriodicPrinter, this);
+  }
+}
+
+void
+KiteDelayTracer::PeriodicPrinter()
+{
+  Print(*m_os);
+  m_printEvent = Simulator::Schedule(m_period, &KiteDelayTracer::PeriodicPrinter, this);
+}
+
+void
+KiteDelayTracer::PrintHeader(std::ostream& os) const
+{
+  os << "Time"
+     << "\t"
+     << "Node"
+     << "\t"
+     << "AppId"
+     << "\t"
+     << "Type"
+     << "\t"
+     << "Count"
+     << "\t"
+     << "P50"
+     << "\t"
+     << "P90"
+     << "\t"
+     << "P99"
+     << "\t"
+     << "P99.9"
+     << "\t"
+     << "Max";
+}
+
+static void
+PrintHistogram(std::ostream& os, const std::string& node, uint32_t appId, const std::string& type,
+               const KiteHistogram& histogram)
+{
+  // microseconds to seconds
+  os << Simulator::Now().ToDouble(Time::S) << "\t" << node << "\t" << appId << "\t" << type << "\t"
+     << histogram.GetCount() << "\t"
+     << histogram.GetPercentile(50) / 1e6 << "\t"
+     << histogram.GetPercentile(90) / 1e6 << "\t"
+     << histogram.GetPercentile(99) / 1e6 << "\t"
+     << histogram.GetPercentile(99.9) / 1e6 << "\t"
+     << histogram.GetMax() / 1e6 << "\n";
+}
+
+void
+KiteDelayTracer::Print(std::ostream& os)
+{
+  for (auto& item : m_lastDelays) {
+    PrintHistogram(os, m_node, item.first, "LastDelay", item.second);
+    item.second.Reset();
+  }
+  for (auto& item : m_fullDelays) {
+    PrintHistogram(os, m_node, item.first, "FullDelay", item.second);
+    item.second.Reset();
+  }
+}
+
+void
+KiteDelayTracer::LastRetransmittedInterestDataDelay(Ptr<App> app, uint32_t seqno, Time delay, int32_t hopCount)
+{
+  m_lastDelays[app->GetId()].Add(delay.GetMicroSeconds());
+}
+
+void
+KiteDelayTracer::FirstInterestDataDelay(Ptr<App> app, uint32_t seqno, Time delay, uint32_t retxCount,
+                                        int32_t hopCount)
+{
+  m_fullDelays[app->GetId()].Add(delay.GetMicroSeconds());
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,112 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NDN_KITE_DELAY_TRACER_H
+#define NDN_KITE_DELAY_TRACER_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/simple-ref-count.h"
+
+#include "kite-histogram.h"
+
+#include <fstream>
+#include <map>
+
+namespace ns3 {
+namespace ndn {
+
+class App;
+
+/**
+ * @ingroup ndn-tracers
+ * @brief Alternative to AppDelayTracer keeping Interest-Data delays in histograms instead of writing them
+ *
+ * Every consumer application gets two KiteHistogram of delays in microseconds, one for the delay since
+ * the last retransmission (LastDelay) and one since the first Interest (FullDelay), like AppDelayTracer.
+ * Every period one row per application and delay type is written with the count, the 50th, 90th, 99th
+ * and 99.9th percentiles and the maximum in seconds, and the histograms start over.
+ * Memory and output size only depend on the number of applications and periods, not on the traffic.
+ */
+class KiteDelayTracer : public SimpleRefCount<KiteDelayTracer> {
+public:
+  /**
+   * @brief Helper method to install tracers on all simulation nodes
+   *
+   * @param file File to which traces will be written.  If filename is -, then std::out is used
+   * @param period How often the percentiles are written
+   */
+  static void
+  InstallAll(const std::string& file, Time period = Seconds(1.0));
+
+  /**
+   * @brief Helper method to install tracers on the selected simulation nodes
+   */
+  static void
+  Install(const NodeContainer& nodes, const std::string& file, Time period = Seconds(1.0));
+
+  /**
+   * @brief Explicit request to remove all statically created tracers
+   */
+  static void
+  Destroy();
+
+  KiteDelayTracer(shared_ptr<std::ostream> os, Ptr<Node> node);
+
+  ~KiteDelayTracer();
+
+  void
+  PrintHeader(std::ostream& os) const;
+
+  void
+  SetPeriod(const Time& period);
+
+private:
+  void
+  PeriodicPrinter();
+
+  void
+  Print(std::ostream& os);
+
+  void
+  LastRetransmittedInterestDataDelay(Ptr<App> app, uint32_t seqno, Time delay, int32_t hopCount);
+
+  void
+  FirstInterestDataDelay(Ptr<App> app, uint32_t seqno, Time delay, uint32_t retxCount, int32_t hopCount);
+
+private:
+  shared_ptr<std::ostream> m_os;
+  Ptr<Node> m_nodePtr;
+  std::string m_node;
+
+  std::map<uint32_t, KiteHistogram> m_lastDelays; ///< @brief by application id
+  std::map<uint32_t, KiteHistogram> m_fullDelays;
+
+  Time m_period;
+  EventId m_printEvent;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_KITE_DELAY_TRACER_H
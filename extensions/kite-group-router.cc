@@ -0,0 +1,193 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "kite-group-router.h"
+
+#include "ns3/log.h"
+#include "ns3/string.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+
+NS_LOG_COMPONENT_DEFINE("ndn.kite.KiteGroupRouter");
+
+namespace ns3 {
+namespace ndn {
+
+NS_OBJECT_ENSURE_REGISTERED(KiteGroupRouter);
+
+static const size_t MAX_PENDING = 1024;
+
+TypeId
+KiteGroupRouter::GetTypeId(void)
+{
+  static TypeId tid =
+    TypeId("ns3::ndn::KiteGroupRouter")
+      .SetGroupName("Ndn")
+      .SetParent<App>()
+      .AddConstructor<KiteGroupRouter>()
+
+      .AddAttribute("AnchorPrefix", "Name of the group trace, <anchor>/<group>", StringValue("/"),
+                    MakeNameAccessor(&KiteGroupRouter::m_anchorPrefix), MakeNameChecker())
+      .AddAttribute("GroupPrefix", "Common prefix of the member devices", StringValue("/"),
+                    MakeNameAccessor(&KiteGroupRouter::m_groupPrefix), MakeNameChecker())
+      .AddAttribute("TraceInterval", "Interval between two traced Interests of the group", StringValue("2.1s"),
+                    MakeTimeAccessor(&KiteGroupRouter::m_traceInterval), MakeTimeChecker())
+      .AddAttribute("InterestLifeTime", "LifeTime for traced Interest packet", StringValue("2s"),
+                    MakeTimeAccessor(&KiteGroupRouter::m_interestLifeTime), MakeTimeChecker())
+    ;
+  return tid;
+}
+
+KiteGroupRouter::KiteGroupRouter()
+  : m_rand(CreateObject<UniformRandomVariable>())
+  , m_traces(0)
+  , m_forwarded(0)
+  , m_answered(0)
+{
+  NS_LOG_FUNCTION_NOARGS();
+}
+
+void
+KiteGroupRouter::StartApplication()
+{
+  NS_LOG_FUNCTION_NOARGS();
+  App::StartApplication();
+
+  SendTrace();
+}
+
+void
+KiteGroupRouter::StopApplication()
+{
+  NS_LOG_FUNCTION_NOARGS();
+
+  Simulator::Cancel(m_traceEvent);
+
+  NS_LOG_INFO("node(" << GetNode()->GetId() << ") group " << m_groupPrefix << " sent " << m_traces
+              << " traced Interests, forwarded " << m_forwarded << " tracing Interests to members, "
+              << m_answered << " answered");
+
+  App::StopApplication();
+}
+
+void
+KiteGroupRouter::SendTrace()
+{
+  if (!m_active)
+    return;
+
+  m_traceEvent = Simulator::Schedule(m_traceInterval, &KiteGroupRouter::SendTrace, this);
+  m_traces++;
+
+  shared_ptr<Interest> interest = make_shared<Interest>();
+  interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+  interest->setName(m_anchorPrefix);
+  interest->setTraceFlag(1);
+  time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
+  interest->setInterestLifetime(interestLifeTime);
+
+  NS_LOG_INFO("> Group traced Interest: " << interest->getName());
+
+  m_transmittedInterests(interest, this, m_face);
+  m_appLink->onReceiveInterest(*interest);
+}
+
+void
+KiteGroupRouter::OnInterest(shared_ptr<const Interest> interest)
+{
+  App::OnInterest(interest); // tracing inside
+
+  if (!m_active)
+    return;
+
+  // <AnchorPrefix>/<member>/<rest>
+  const Name& name = interest->getName();
+  if (name.size() <= m_anchorPrefix.size() || !m_anchorPrefix.isPrefixOf(name)) {
+    NS_LOG_DEBUG("Not addressed to a member: " << name);
+    return;
+  }
+
+  Name memberName(m_groupPrefix);
+  memberName.append(name.getSubName(m_anchorPrefix.size()));
+
+  if (m_pending.size() >= MAX_PENDING) {
+    ExpirePending();
+  }
+
+  PendingInterest& pending = m_pending[memberName];
+  pending.originalName = name;
+  pending.expiry = Simulator::Now() + MilliSeconds(interest->getInterestLifetime().count());
+
+  shared_ptr<Interest> forwarded = make_shared<Interest>();
+  forwarded->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+  forwarded->setName(memberName);
+  forwarded->setInterestLifetime(interest->getInterestLifetime());
+  m_forwarded++;
+
+  NS_LOG_INFO("> Forwarding " << name << " to member as " << memberName);
+
+  m_transmittedInterests(forwarded, this, m_face);
+  m_appLink->onReceiveInterest(*forwarded);
+}
+
+void
+KiteGroupRouter::OnData(shared_ptr<const Data> memberData)
+{
+  App::OnData(memberData); // tracing inside
+
+  auto pending = m_pending.find(memberData->getName());
+  if (pending == m_pending.end()) {
+    NS_LOG_DEBUG("Unsolicited Data from member: " << memberData->getName());
+    return;
+  }
+
+  auto data = make_shared<Data>();
+  data->setName(pending->second.originalName);
+  data->setFreshnessPeriod(::ndn::time::milliseconds(0));
+  data->setContent(memberData->getContent());
+  m_pending.erase(pending);
+
+  Signature signature;
+  SignatureInfo signatureInfo(static_cast< ::ndn::tlv::SignatureTypeValue>(255));
+  signature.setInfo(signatureInfo);
+  signature.setValue(::ndn::makeNonNegativeIntegerBlock(::ndn::tlv::SignatureValue, 0));
+  data->setSignature(signature);
+
+  NS_LOG_INFO("node(" << GetNode()->GetId() << ") answering for member with Data: " << data->getName());
+
+  data->wireEncode();
+  m_answered++;
+
+  m_transmittedDatas(data, this, m_face);
+  m_appLink->onReceiveData(*data);
+}
+
+void
+KiteGroupRouter::ExpirePending()
+{
+  for (auto it = m_pending.begin(); it != m_pending.end();) {
+    if (it->second.expiry <= Simulator::Now())
+      it = m_pending.erase(it);
+    else
+      ++it;
+  }
+}
+
+} // namespace ndn
+} // namespace ns3
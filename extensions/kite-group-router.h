@@ -0,0 +1,110 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NDN_KITE_GROUP_ROUTER_H
+#define NDN_KITE_GROUP_ROUTER_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "ns3/ndnSIM/apps/ndn-app.hpp"
+
+#include "ns3/random-variable-stream.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+#include <map>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-apps
+ * @brief Ndn application that keeps one pull trace for all devices behind a mobile router, e.g. a vehicle
+ *
+ * The router sends a traced Interest named AnchorPrefix every TraceInterval, like KitePullMobile does for a
+ * single device, and member devices (plain producers on nodes behind the router) send no traces at all.
+ * Servers address member <member> with tracing Interests named <AnchorPrefix>/<member>/<rest> that carry
+ * AnchorPrefix as trace name.  Such an Interest comes down the group trace to the router, which forwards it
+ * as a plain Interest for <GroupPrefix>/<member>/<rest> over the FIB of its node, and answers the original
+ * Interest with the content of the Data the member returns.
+ *
+ * Routers on the path thus hold one trace entry per group, and the access network carries one traced
+ * Interest per group and interval, whatever the number of members.
+ */
+class KiteGroupRouter : public App {
+public:
+  static TypeId
+  GetTypeId();
+
+  KiteGroupRouter();
+
+  virtual void
+  OnInterest(shared_ptr<const Interest> interest);
+
+  virtual void
+  OnData(shared_ptr<const Data> data);
+
+protected:
+  // inherited from Application base class.
+  virtual void
+  StartApplication();
+
+  virtual void
+  StopApplication();
+
+  /**
+   * @brief Send the traced Interest of the group and schedule the next one
+   */
+  void
+  SendTrace();
+
+  /**
+   * @brief Drop forwarded Interests whose member did not answer within their lifetime
+   */
+  void
+  ExpirePending();
+
+private:
+  /**
+   * @brief Tracing Interest waiting for the answer of a member
+   */
+  struct PendingInterest
+  {
+    Name originalName;
+    Time expiry;
+  };
+
+  Name m_anchorPrefix;
+  Name m_groupPrefix;
+  Time m_traceInterval;
+  Time m_interestLifeTime;
+
+  Ptr<UniformRandomVariable> m_rand; ///< @brief nonce generator
+  EventId m_traceEvent;
+
+  std::map<Name, PendingInterest> m_pending; ///< @brief by name of the forwarded Interest
+  uint32_t m_traces;
+  uint32_t m_forwarded;
+  uint32_t m_answered;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_KITE_GROUP_ROUTER_H
@@ -0,0 +1,204 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "kite-handoff-predictor.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/double.h"
+#include "ns3/mobility-model.h"
+
+#include <cmath>
+#include <sstream>
+
+NS_LOG_COMPONENT_DEFINE("ndn.kite.KiteHandoffPredictor");
+
+namespace ns3 {
+namespace ndn {
+
+NS_OBJECT_ENSURE_REGISTERED(KiteHandoffPredictor);
+
+TypeId
+KiteHandoffPredictor::GetTypeId(void)
+{
+  static TypeId tid =
+    TypeId("ns3::ndn::KiteHandoffPredictor")
+      .SetGroupName("Ndn")
+      .SetParent<Object>()
+      .AddConstructor<KiteHandoffPredictor>()
+
+      .AddAttribute("AccessPoints", "Whitespace separated x:y positions of the access points, empty to disable prediction",
+                    StringValue(""),
+                    MakeStringAccessor(&KiteHandoffPredictor::SetAccessPoints, &KiteHandoffPredictor::GetAccessPoints),
+                    MakeStringChecker())
+
+      .AddAttribute("AccessPointRange", "Radio range of the access points in meters", DoubleValue(110.0),
+                    MakeDoubleAccessor(&KiteHandoffPredictor::m_range), MakeDoubleChecker<double>(0.0))
+
+      .AddAttribute("PredictInterval", "Interval between two handoff predictions", StringValue("100ms"),
+                    MakeTimeAccessor(&KiteHandoffPredictor::m_interval), MakeTimeChecker())
+
+      .AddAttribute("PredictHorizon", "How far ahead entries into the range of an access point are predicted",
+                    StringValue("1s"),
+                    MakeTimeAccessor(&KiteHandoffPredictor::m_horizon), MakeTimeChecker())
+    ;
+
+  return tid;
+}
+
+KiteHandoffPredictor::KiteHandoffPredictor()
+  : m_range(110.0)
+  , m_interval(MilliSeconds(100))
+  , m_horizon(Seconds(1))
+{
+}
+
+void
+KiteHandoffPredictor::DoDispose()
+{
+  Stop();
+  m_node = 0;
+  Object::DoDispose();
+}
+
+void
+KiteHandoffPredictor::SetAccessPoints(const std::string& positions)
+{
+  m_positions = positions;
+  m_accessPoints.clear();
+
+  std::istringstream is(positions);
+  std::string position;
+  while (is >> position) {
+    double x = 0;
+    double y = 0;
+    char separator = 0;
+    std::istringstream ps(position);
+    if (!(ps >> x >> separator >> y) || separator != ':') {
+      NS_LOG_WARN("Ignoring malformed access point position " << position);
+      continue;
+    }
+    m_accessPoints.push_back(Vector(x, y, 0.0));
+  }
+}
+
+std::string
+KiteHandoffPredictor::GetAccessPoints() const
+{
+  return m_positions;
+}
+
+int
+KiteHandoffPredictor::GetCurrent(const Vector& position) const
+{
+  int current = -1;
+  double nearest = m_range;
+  for (size_t i = 0; i < m_accessPoints.size(); i++) {
+    double dx = position.x - m_accessPoints[i].x;
+    double dy = position.y - m_accessPoints[i].y;
+    double distance = std::sqrt(dx * dx + dy * dy);
+    if (distance <= nearest) {
+      nearest = distance;
+      current = i;
+    }
+  }
+  return current;
+}
+
+bool
+KiteHandoffPredictor::PredictNext(const Vector& position, const Vector& velocity, Time horizon,
+                                  int& next, Time& delay) const
+{
+  double a = velocity.x * velocity.x + velocity.y * velocity.y;
+  if (a == 0)
+    return false; // standing still
+
+  double earliest = horizon.GetSeconds();
+  next = -1;
+  for (size_t i = 0; i < m_accessPoints.size(); i++) {
+    double dx = position.x - m_accessPoints[i].x;
+    double dy = position.y - m_accessPoints[i].y;
+    double c = dx * dx + dy * dy - m_range * m_range;
+    if (c <= 0)
+      continue; // already in range
+
+    // |d + v t| = range
+    double b = 2 * (dx * velocity.x + dy * velocity.y);
+    double discriminant = b * b - 4 * a * c;
+    if (discriminant < 0)
+      continue; // passing by
+
+    double entry = (-b - std::sqrt(discriminant)) / (2 * a);
+    if (entry > 0 && entry <= earliest) {
+      earliest = entry;
+      next = i;
+    }
+  }
+
+  if (next < 0)
+    return false;
+
+  delay = Seconds(earliest);
+  return true;
+}
+
+void
+KiteHandoffPredictor::Start(Ptr<Node> node, Callback<void> handoff)
+{
+  Stop();
+  if (m_accessPoints.empty())
+    return;
+
+  m_node = node;
+  m_handoff = handoff;
+  Predict();
+}
+
+void
+KiteHandoffPredictor::Stop()
+{
+  Simulator::Cancel(m_predictEvent);
+  Simulator::Cancel(m_handoffEvent);
+}
+
+void
+KiteHandoffPredictor::Predict()
+{
+  Ptr<MobilityModel> mobility = m_node->GetObject<MobilityModel>();
+  int next = -1;
+  Time delay;
+  // a handoff already scheduled is kept, the next prediction after it looks further
+  if (mobility != 0 && !m_handoffEvent.IsRunning()
+      && PredictNext(mobility->GetPosition(), mobility->GetVelocity(), m_horizon, next, delay)) {
+    NS_LOG_INFO("node(" << m_node->GetId() << ") reaching access point " << next << " (now at "
+                << GetCurrent(mobility->GetPosition()) << ") in " << delay.GetMilliSeconds() << "ms");
+    m_handoffEvent = Simulator::Schedule(delay, &KiteHandoffPredictor::Handoff, this);
+  }
+
+  m_predictEvent = Simulator::Schedule(m_interval, &KiteHandoffPredictor::Predict, this);
+}
+
+void
+KiteHandoffPredictor::Handoff()
+{
+  m_handoff();
+}
+
+} // namespace ndn
+} // namespace ns3
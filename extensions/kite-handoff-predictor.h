@@ -0,0 +1,127 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NDN_KITE_HANDOFF_PREDICTOR_H
+#define NDN_KITE_HANDOFF_PREDICTOR_H
+
+#include "ns3/object.h"
+#include "ns3/node.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include "ns3/event-id.h"
+#include "ns3/callback.h"
+
+#include <string>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-apps
+ * @brief Predicts when a mobile moving at constant velocity comes within range of the next access point
+ *
+ * Used by mobile applications to send a traced Interest the moment the next access point can hear them,
+ * so that the trace through the new access point exists before the old one is out of reach.
+ * Once started, the predictor extrapolates the position of the node every PredictInterval and schedules
+ * the handoff callback for the first entry into the range of an access point within PredictHorizon.
+ *
+ * Applications own one instance each and expose it through their HandoffPredictor attribute;
+ * scenarios set the positions with Config::SetDefault("ns3::ndn::KiteHandoffPredictor::AccessPoints", ...).
+ */
+class KiteHandoffPredictor : public Object {
+public:
+  static TypeId
+  GetTypeId();
+
+  KiteHandoffPredictor();
+
+  /**
+   * @brief Set the access point positions from a whitespace separated list of x:y pairs
+   */
+  void
+  SetAccessPoints(const std::string& positions);
+
+  std::string
+  GetAccessPoints() const;
+
+  size_t
+  GetAccessPointCount() const
+  {
+    return m_accessPoints.size();
+  }
+
+  void
+  SetRange(double range)
+  {
+    m_range = range;
+  }
+
+  /**
+   * @brief Index of the nearest access point in range, -1 if none
+   */
+  int
+  GetCurrent(const Vector& position) const;
+
+  /**
+   * @brief Find the first access point, not in range yet, whose range the mobile enters within horizon
+   * @param next index of that access point
+   * @param delay time until the mobile enters its range
+   * @returns false if no access point is reached within horizon
+   */
+  bool
+  PredictNext(const Vector& position, const Vector& velocity, Time horizon, int& next, Time& delay) const;
+
+  /**
+   * @brief Start predicting the handoffs of the node, does nothing without access points
+   */
+  void
+  Start(Ptr<Node> node, Callback<void> handoff);
+
+  void
+  Stop();
+
+protected:
+  virtual void
+  DoDispose();
+
+private:
+  void
+  Predict();
+
+  void
+  Handoff();
+
+private:
+  std::string m_positions;
+  std::vector<Vector> m_accessPoints;
+  double m_range;
+  Time m_interval;
+  Time m_horizon;
+
+  Ptr<Node> m_node;
+  Callback<void> m_handoff;
+  EventId m_predictEvent;
+  EventId m_handoffEvent;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_KITE_HANDOFF_PREDICTOR_H
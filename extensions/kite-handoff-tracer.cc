@@ -0,0 +1,327 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "kite-handoff-tracer.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/nstime.h"
+#include "ns3/mobility-model.h"
+
+#include "model/ndn-l3-protocol.hpp"
+
+#include <fstream>
+#include <list>
+#include <tuple>
+
+NS_LOG_COMPONENT_DEFINE("ndn.kite.KiteHandoffTracer");
+
+namespace ns3 {
+namespace ndn {
+
+NS_OBJECT_ENSURE_REGISTERED(KiteHandoffTracer);
+
+const uint32_t KiteHandoffTracer::NO_AP = std::numeric_limits<uint32_t>::max();
+
+static std::list<std::tuple<Ptr<KiteHandoffTracer>, shared_ptr<std::ostream>>> g_handoffTracers;
+
+TypeId
+KiteHandoffTracer::GetTypeId()
+{
+  static TypeId tid =
+    TypeId("ns3::ndn::KiteHandoffTracer")
+      .SetGroupName("Ndn")
+      .SetParent<Object>()
+      .AddConstructor<KiteHandoffTracer>()
+
+      .AddAttribute("Range", "Distance (m) under which an access point is considered reachable",
+                    DoubleValue(110.0),
+                    MakeDoubleAccessor(&KiteHandoffTracer::m_range), MakeDoubleChecker<double>(0.0))
+      .AddAttribute("SampleInterval", "Interval between two checks of the point of attachment",
+                    StringValue("10ms"),
+                    MakeTimeAccessor(&KiteHandoffTracer::m_sampleInterval), MakeTimeChecker())
+      .AddAttribute("BinWidth", "Width of a histogram bin", StringValue("50ms"),
+                    MakeTimeAccessor(&KiteHandoffTracer::m_binWidth), MakeTimeChecker())
+
+      .AddTraceSource("HandoffRecovered",
+                      "Handoff event with the delays until traced Interest and Data resumed",
+                      MakeTraceSourceAccessor(&KiteHandoffTracer::m_handoffRecovered),
+                      "ns3::ndn::KiteHandoffTracer::HandoffRecoveredCallback")
+    ;
+  return tid;
+}
+
+static shared_ptr<std::ostream>
+OpenOutputStream(const std::string& file)
+{
+  if (file == "-") {
+    return shared_ptr<std::ostream>(&std::cout, std::bind([]{}));
+  }
+
+  shared_ptr<std::ofstream> os(new std::ofstream());
+  os->open(file.c_str(), std::ios_base::out | std::ios_base::trunc);
+
+  if (!os->is_open()) {
+    NS_LOG_ERROR("File " << file << " cannot be opened for writing. Tracing disabled");
+    return nullptr;
+  }
+  return os;
+}
+
+Ptr<KiteHandoffTracer>
+KiteHandoffTracer::Install(Ptr<Node> mobile, const NodeContainer& accessPoints, Ptr<Node> anchor,
+                           const std::string& file, const std::string& histogramFile)
+{
+  shared_ptr<std::ostream> outputStream = OpenOutputStream(file);
+  if (outputStream == nullptr)
+    return 0;
+
+  shared_ptr<std::ostream> histogramStream;
+  if (!histogramFile.empty()) {
+    histogramStream = OpenOutputStream(histogramFile);
+  }
+
+  Ptr<KiteHandoffTracer> tracer = CreateObject<KiteHandoffTracer>();
+  tracer->m_mobile = mobile;
+  tracer->m_accessPoints = accessPoints;
+  tracer->m_anchor = anchor;
+  tracer->m_os = outputStream;
+  tracer->Connect();
+
+  mobile->AggregateObject(tracer);
+
+  tracer->PrintHeader(*outputStream);
+  *outputStream << "\n";
+
+  if (g_handoffTracers.empty()) {
+    Simulator::ScheduleDestroy(&KiteHandoffTracer::Destroy);
+  }
+  g_handoffTracers.push_back(std::make_tuple(tracer, histogramStream));
+
+  return tracer;
+}
+
+void
+KiteHandoffTracer::Destroy()
+{
+  for (auto& item : g_handoffTracers) {
+    Ptr<KiteHandoffTracer> tracer = std::get<0>(item);
+    shared_ptr<std::ostream> histogramStream = std::get<1>(item);
+
+    if (tracer->m_inOutage) {
+      tracer->m_unrecovered++;
+    }
+    if (histogramStream != nullptr) {
+      tracer->PrintHistograms(*histogramStream);
+    }
+  }
+  g_handoffTracers.clear();
+}
+
+KiteHandoffTracer::KiteHandoffTracer()
+  : m_range(110.0)
+  , m_sampleInterval(MilliSeconds(10))
+  , m_binWidth(MilliSeconds(50))
+  , m_currentAp(NO_AP)
+  , m_inOutage(false)
+  , m_fromAp(NO_AP)
+  , m_handoffs(0)
+  , m_unrecovered(0)
+{
+}
+
+KiteHandoffTracer::~KiteHandoffTracer()
+{
+  m_sampleEvent.Cancel();
+}
+
+void
+KiteHandoffTracer::Connect()
+{
+  Ptr<L3Protocol> mobileL3 = m_mobile->GetObject<L3Protocol>();
+  mobileL3->TraceConnectWithoutContext("OutInterests",
+                                       MakeCallback(&KiteHandoffTracer::MobileOutInterests, this));
+  mobileL3->TraceConnectWithoutContext("InData", MakeCallback(&KiteHandoffTracer::MobileData, this));
+  mobileL3->TraceConnectWithoutContext("OutData", MakeCallback(&KiteHandoffTracer::MobileData, this));
+
+  Ptr<L3Protocol> anchorL3 = m_anchor->GetObject<L3Protocol>();
+  anchorL3->TraceConnectWithoutContext("InInterests",
+                                       MakeCallback(&KiteHandoffTracer::AnchorInInterests, this));
+
+  // attributes may still be changed after Install(), so only start sampling once the simulation runs
+  m_sampleEvent = Simulator::ScheduleNow(&KiteHandoffTracer::CheckAttachment, this);
+}
+
+void
+KiteHandoffTracer::PrintHeader(std::ostream& os) const
+{
+  os << "Time"
+     << "\t"
+     << "Node"
+     << "\t"
+     << "FromAp"
+     << "\t"
+     << "ToAp"
+     << "\t"
+     << "TracedDelay"
+     << "\t"
+     << "DataDelay";
+}
+
+void
+KiteHandoffTracer::PrintHistograms(std::ostream& os) const
+{
+  os << "Node"
+     << "\t"
+     << "Type"
+     << "\t"
+     << "BinStart"
+     << "\t"
+     << "BinEnd"
+     << "\t"
+     << "Count"
+     << "\n";
+
+  auto printHistogram = [&] (const std::string& type, const std::map<int64_t, uint32_t>& histogram) {
+    for (const auto& bin : histogram) {
+      os << m_mobile->GetId() << "\t" << type << "\t"
+         << NanoSeconds(m_binWidth.GetNanoSeconds() * bin.first).ToDouble(Time::S) << "\t"
+         << NanoSeconds(m_binWidth.GetNanoSeconds() * (bin.first + 1)).ToDouble(Time::S) << "\t"
+         << bin.second << "\n";
+    }
+  };
+
+  printHistogram("TracedDelay", m_tracedHistogram);
+  printHistogram("DataDelay", m_dataHistogram);
+
+  os << m_mobile->GetId() << "\t" << "Handoffs" << "\t" << -1 << "\t" << -1 << "\t" << m_handoffs << "\n";
+  os << m_mobile->GetId() << "\t" << "Unrecovered" << "\t" << -1 << "\t" << -1 << "\t" << m_unrecovered << "\n";
+}
+
+void
+KiteHandoffTracer::CheckAttachment()
+{
+  Vector position = m_mobile->GetObject<MobilityModel>()->GetPosition();
+
+  uint32_t nearestAp = NO_AP;
+  double nearestDistance = m_range;
+  for (NodeContainer::Iterator i = m_accessPoints.Begin(); i != m_accessPoints.End(); ++i) {
+    double distance = CalculateDistance(position, (*i)->GetObject<MobilityModel>()->GetPosition());
+    if (distance <= nearestDistance) {
+      nearestDistance = distance;
+      nearestAp = (*i)->GetId();
+    }
+  }
+
+  // Leaving coverage is not a handoff, attaching to a different access point is.
+  if (nearestAp != NO_AP && nearestAp != m_currentAp) {
+    if (m_currentAp != NO_AP) {
+      if (m_inOutage) {
+        // the previous handoff never recovered before the next one
+        m_unrecovered++;
+        *m_os << m_handoffTime.ToDouble(Time::S) << "\t" << m_mobile->GetId() << "\t"
+              << m_fromAp << "\t" << m_currentAp << "\t"
+              << (m_tracedDelay.IsNegative() ? -1 : m_tracedDelay.ToDouble(Time::S)) << "\t"
+              << (m_dataDelay.IsNegative() ? -1 : m_dataDelay.ToDouble(Time::S)) << "\n";
+      }
+
+      NS_LOG_INFO("Handoff of node(" << m_mobile->GetId() << ") from AP " << m_currentAp
+                  << " to AP " << nearestAp);
+
+      m_handoffs++;
+      m_inOutage = true;
+      m_fromAp = m_currentAp;
+      m_handoffTime = Simulator::Now();
+      m_tracedDelay = Seconds(-1);
+      m_dataDelay = Seconds(-1);
+      m_tracedNonces.clear();
+    }
+    m_currentAp = nearestAp;
+  }
+
+  m_sampleEvent = Simulator::Schedule(m_sampleInterval, &KiteHandoffTracer::CheckAttachment, this);
+}
+
+void
+KiteHandoffTracer::MobileOutInterests(const Interest& interest, const Face& face)
+{
+  if (!m_inOutage || interest.getTraceFlag() != 1)
+    return;
+
+  if (face.getScope() != ::ndn::nfd::FACE_SCOPE_NON_LOCAL)
+    return;
+
+  m_tracedNonces.insert(interest.getNonce());
+}
+
+void
+KiteHandoffTracer::MobileData(const Data& data, const Face& face)
+{
+  if (!m_inOutage || !m_dataDelay.IsNegative())
+    return;
+
+  if (face.getScope() != ::ndn::nfd::FACE_SCOPE_NON_LOCAL)
+    return;
+
+  m_dataDelay = Simulator::Now() - m_handoffTime;
+  TryComplete();
+}
+
+void
+KiteHandoffTracer::AnchorInInterests(const Interest& interest, const Face& face)
+{
+  if (!m_inOutage || !m_tracedDelay.IsNegative() || interest.getTraceFlag() != 1)
+    return;
+
+  if (m_tracedNonces.count(interest.getNonce()) == 0)
+    return;
+
+  m_tracedDelay = Simulator::Now() - m_handoffTime;
+  TryComplete();
+}
+
+void
+KiteHandoffTracer::TryComplete()
+{
+  if (m_tracedDelay.IsNegative() || m_dataDelay.IsNegative())
+    return;
+
+  m_inOutage = false;
+  m_tracedNonces.clear();
+
+  Record(m_tracedHistogram, m_tracedDelay);
+  Record(m_dataHistogram, m_dataDelay);
+
+  *m_os << m_handoffTime.ToDouble(Time::S) << "\t" << m_mobile->GetId() << "\t"
+        << m_fromAp << "\t" << m_currentAp << "\t"
+        << m_tracedDelay.ToDouble(Time::S) << "\t" << m_dataDelay.ToDouble(Time::S) << "\n";
+
+  m_handoffRecovered(m_fromAp, m_currentAp, m_tracedDelay, m_dataDelay);
+}
+
+void
+KiteHandoffTracer::Record(std::map<int64_t, uint32_t>& histogram, Time delay)
+{
+  int64_t bin = delay.GetNanoSeconds() / m_binWidth.GetNanoSeconds();
+  histogram[bin]++;
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,145 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NDN_KITE_HANDOFF_TRACER_H
+#define NDN_KITE_HANDOFF_TRACER_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/ndnSIM/NFD/daemon/face/face.hpp"
+
+#include "ns3/object.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/traced-callback.h"
+
+#include <map>
+#include <set>
+#include <fstream>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-tracers
+ * @brief Measures how long Kite needs to recover after a mobile changes its point of attachment.
+ *
+ * The mobile's position is sampled periodically and compared against the known access points,
+ * the nearest access point within range being the current point of attachment.
+ * Every change of attachment is a handoff event. For each event the tracer records
+ * the time until the next traced Interest (TraceFlag 1) sent by the mobile reaches the anchor
+ * (the stationary server in upload scenarios), and the time until Data flows through the
+ * mobile's wireless face again.
+ *
+ * One row is written per handoff, and per-run histograms of both delays are written
+ * when the simulation is destroyed.
+ */
+class KiteHandoffTracer : public Object {
+public:
+  static TypeId
+  GetTypeId();
+
+  /**
+   * @brief Install the tracer on a mobile node
+   * @param mobile        mobile node whose handoffs are measured
+   * @param accessPoints  stationary nodes the mobile may attach to over wifi
+   * @param anchor        node at which traced Interests terminate (anchor or upload server)
+   * @param file          output file for per-handoff rows ("-" for stdout)
+   * @param histogramFile output file for per-run histograms ("" to disable)
+   */
+  static Ptr<KiteHandoffTracer>
+  Install(Ptr<Node> mobile, const NodeContainer& accessPoints, Ptr<Node> anchor,
+          const std::string& file, const std::string& histogramFile = "");
+
+  /**
+   * @brief Destroy all tracers installed with Install(), flushing histograms
+   */
+  static void
+  Destroy();
+
+  KiteHandoffTracer();
+  virtual ~KiteHandoffTracer();
+
+  void
+  PrintHeader(std::ostream& os) const;
+
+  void
+  PrintHistograms(std::ostream& os) const;
+
+  typedef void (*HandoffRecoveredCallback)(uint32_t fromAp, uint32_t toAp,
+                                           Time tracedDelay, Time dataDelay);
+
+private:
+  void
+  Connect();
+
+  void
+  CheckAttachment();
+
+  void
+  MobileOutInterests(const Interest& interest, const Face& face);
+
+  void
+  MobileData(const Data& data, const Face& face);
+
+  void
+  AnchorInInterests(const Interest& interest, const Face& face);
+
+  void
+  TryComplete();
+
+  void
+  Record(std::map<int64_t, uint32_t>& histogram, Time delay);
+
+private:
+  static const uint32_t NO_AP;
+
+  Ptr<Node> m_mobile;
+  NodeContainer m_accessPoints;
+  Ptr<Node> m_anchor;
+  shared_ptr<std::ostream> m_os;
+
+  double m_range;
+  Time m_sampleInterval;
+  Time m_binWidth;
+  EventId m_sampleEvent;
+
+  uint32_t m_currentAp;
+
+  // state of the handoff currently being measured
+  bool m_inOutage;
+  uint32_t m_fromAp;
+  Time m_handoffTime;
+  Time m_tracedDelay;
+  Time m_dataDelay;
+  std::set<uint32_t> m_tracedNonces; ///< @brief nonces of traced Interests sent since the handoff
+
+  uint32_t m_handoffs;
+  uint32_t m_unrecovered;
+  std::map<int64_t, uint32_t> m_tracedHistogram;
+  std::map<int64_t, uint32_t> m_dataHistogram;
+
+  TracedCallback<uint32_t, uint32_t, Time, Time> m_handoffRecovered;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_KITE_HANDOFF_TRACER_H
@@ -0,0 +1,93 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "kite-histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3 {
+namespace ndn {
+
+KiteHistogram::KiteHistogram()
+  : m_counts((64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS, 0)
+  , m_count(0)
+  , m_max(0)
+{
+}
+
+uint32_t
+KiteHistogram::GetIndex(uint64_t value)
+{
+  if (value < SUB_BUCKETS)
+    return value;
+
+  uint32_t msb = 63 - __builtin_clzll(value);
+  uint32_t shift = msb - SUB_BUCKET_BITS;
+  // value >> shift lies in [SUB_BUCKETS, 2 * SUB_BUCKETS)
+  return (shift + 1) * SUB_BUCKETS + static_cast<uint32_t>((value >> shift) - SUB_BUCKETS);
+}
+
+uint64_t
+KiteHistogram::GetHighestValue(uint32_t index)
+{
+  if (index < SUB_BUCKETS)
+    return index;
+
+  uint32_t shift = index / SUB_BUCKETS - 1;
+  uint64_t lowest = static_cast<uint64_t>(SUB_BUCKETS + index % SUB_BUCKETS) << shift;
+  return lowest + ((static_cast<uint64_t>(1) << shift) - 1);
+}
+
+void
+KiteHistogram::Add(uint64_t value)
+{
+  m_counts[GetIndex(value)]++;
+  m_count++;
+  m_max = std::max(m_max, value);
+}
+
+void
+KiteHistogram::Reset()
+{
+  std::fill(m_counts.begin(), m_counts.end(), 0);
+  m_count = 0;
+  m_max = 0;
+}
+
+uint64_t
+KiteHistogram::GetPercentile(double percentile) const
+{
+  if (m_count == 0)
+    return 0;
+
+  uint64_t rank = static_cast<uint64_t>(std::ceil(percentile / 100 * m_count));
+  rank = std::max<uint64_t>(1, std::min(rank, m_count));
+
+  uint64_t seen = 0;
+  for (uint32_t index = 0; index < m_counts.size(); index++) {
+    seen += m_counts[index];
+    if (seen >= rank)
+      return std::min(GetHighestValue(index), m_max);
+  }
+  return m_max;
+}
+
+} // namespace ndn
+} // namespace ns3
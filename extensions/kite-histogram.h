@@ -0,0 +1,86 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NDN_KITE_HISTOGRAM_H
+#define NDN_KITE_HISTOGRAM_H
+
+#include <cstdint>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Log-linear histogram of non-negative integer values, in the manner of HdrHistogram
+ *
+ * Values below 2^SUB_BUCKET_BITS are counted exactly.  Above, every power of two is split into
+ * 2^SUB_BUCKET_BITS equal buckets, so that any value is known within 1/2^SUB_BUCKET_BITS (about 3%)
+ * of itself.  The histogram covers the whole uint64_t range with a fixed number of counters.
+ */
+class KiteHistogram {
+public:
+  KiteHistogram();
+
+  void
+  Add(uint64_t value);
+
+  void
+  Reset();
+
+  uint64_t
+  GetCount() const
+  {
+    return m_count;
+  }
+
+  uint64_t
+  GetMax() const
+  {
+    return m_max;
+  }
+
+  /**
+   * @brief Highest value equivalent to the given percentile (0 to 100), 0 if the histogram is empty
+   */
+  uint64_t
+  GetPercentile(double percentile) const;
+
+  static const uint32_t SUB_BUCKET_BITS = 5;
+  static const uint32_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+
+private:
+  static uint32_t
+  GetIndex(uint64_t value);
+
+  /**
+   * @brief Largest value counted in the given bucket
+   */
+  static uint64_t
+  GetHighestValue(uint32_t index);
+
+private:
+  std::vector<uint64_t> m_counts;
+  uint64_t m_count;
+  uint64_t m_max;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_KITE_HISTOGRAM_H
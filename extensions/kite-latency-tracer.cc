@@ -0,0 +1,347 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "kite-latency-tracer.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/node-list.h"
+#include "ns3/names.h"
+#include "ns3/callback.h"
+
+#include "ns3/ndnSIM/apps/ndn-app.hpp"
+#include "model/ndn-l3-protocol.hpp"
+
+#include <boost/lexical_cast.hpp>
+
+#include <list>
+#include <map>
+#include <tuple>
+#include <vector>
+
+NS_LOG_COMPONENT_DEFINE("ndn.kite.KiteLatencyTracer");
+
+namespace ns3 {
+namespace ndn {
+
+static std::list<std::tuple<shared_ptr<std::ostream>, std::list<Ptr<KiteLatencyTracer>>>> g_tracers;
+
+namespace {
+
+/**
+ * @brief Traced Interest of a mobile on its way to the server
+ */
+struct Request
+{
+  Time sent;
+  Time arrived;
+  Time expiry;
+};
+
+/**
+ * @brief Tracing Interest and Data of one segment
+ */
+struct Segment
+{
+  Time requestSent;    ///< @brief zero if the request was not seen
+  Time requestArrived;
+  Time tracingSent;
+  Time tracingArrived; ///< @brief zero until the mobile got the tracing Interest
+  Time expiry;         ///< @brief end of the lifetime of the latest tracing Interest
+  std::vector<std::tuple<std::string, std::string, Time>> hops; ///< @brief node, packet, time since tracingSent
+};
+
+std::map<Name, Request> g_requests; ///< @brief by traced Interest name, the latest one
+std::map<Name, Segment> g_segments; ///< @brief by segment name
+std::multimap<Time, std::pair<Name, bool>> g_expiries; ///< @brief expiry -> name, true for a segment
+
+/**
+ * @brief Forget the requests and segments whose Interest expired, the Data cannot come any more
+ */
+void
+ExpireEntries()
+{
+  Time now = Simulator::Now();
+  while (!g_expiries.empty() && g_expiries.begin()->first <= now) {
+    const Name& name = g_expiries.begin()->second.first;
+    // an entry sent again since then has a later expiry of its own
+    if (g_expiries.begin()->second.second) {
+      auto segment = g_segments.find(name);
+      if (segment != g_segments.end() && segment->second.expiry <= now) {
+        g_segments.erase(segment);
+      }
+    }
+    else {
+      auto request = g_requests.find(name);
+      if (request != g_requests.end() && request->second.expiry <= now) {
+        g_requests.erase(request);
+      }
+    }
+    g_expiries.erase(g_expiries.begin());
+  }
+}
+
+} // namespace
+
+void
+KiteLatencyTracer::Destroy()
+{
+  g_tracers.clear();
+  g_requests.clear();
+  g_segments.clear();
+  g_expiries.clear();
+}
+
+void
+KiteLatencyTracer::InstallAll(const std::string& file, const std::string& hopFile)
+{
+  NodeContainer nodes;
+  for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
+    nodes.Add(*node);
+  }
+
+  Install(nodes, file, hopFile);
+}
+
+void
+KiteLatencyTracer::Install(const NodeContainer& nodes, const std::string& file, const std::string& hopFile)
+{
+  std::list<Ptr<KiteLatencyTracer>> tracers;
+  shared_ptr<std::ostream> outputStream;
+  if (file != "-") {
+    shared_ptr<std::ofstream> os(new std::ofstream());
+    os->open(file.c_str(), std::ios_base::out | std::ios_base::trunc);
+
+    if (!os->is_open()) {
+      NS_LOG_ERROR("File " << file << " cannot be opened for writing. Tracing disabled");
+      return;
+    }
+
+    outputStream = os;
+  }
+  else {
+    outputStream = shared_ptr<std::ostream>(&std::cout, std::bind([]{}));
+  }
+
+  shared_ptr<std::ostream> hopStream;
+  if (!hopFile.empty()) {
+    shared_ptr<std::ofstream> os(new std::ofstream());
+    os->open(hopFile.c_str(), std::ios_base::out | std::ios_base::trunc);
+
+    if (!os->is_open()) {
+      NS_LOG_ERROR("File " << hopFile << " cannot be opened for writing. Hop tracing disabled");
+    }
+    else {
+      hopStream = os;
+    }
+  }
+
+  for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); node++) {
+    if ((*node)->GetObject<L3Protocol>() == 0)
+      continue;
+
+    Ptr<KiteLatencyTracer> trace = Create<KiteLatencyTracer>(outputStream, hopStream, *node);
+    tracers.push_back(trace);
+  }
+
+  if (tracers.size() > 0) {
+    tracers.front()->PrintHeader(*outputStream);
+    *outputStream << "\n";
+    if (hopStream != nullptr) {
+      tracers.front()->PrintHopHeader(*hopStream);
+      *hopStream << "\n";
+    }
+  }
+
+  if (g_tracers.empty()) {
+    Simulator::ScheduleDestroy(&KiteLatencyTracer::Destroy);
+  }
+  g_tracers.push_back(std::make_tuple(outputStream, tracers));
+}
+
+KiteLatencyTracer::KiteLatencyTracer(shared_ptr<std::ostream> os, shared_ptr<std::ostream> hopOs, Ptr<Node> node)
+  : m_os(os)
+  , m_hopOs(hopOs)
+  , m_nodePtr(node)
+{
+  m_node = boost::lexical_cast<std::string>(m_nodePtr->GetId());
+
+  std::string name = Names::FindName(node);
+  if (!name.empty()) {
+    m_node = name;
+  }
+
+  for (uint32_t i = 0; i < node->GetNApplications(); i++) {
+    Ptr<App> app = DynamicCast<App>(node->GetApplication(i));
+    if (app == 0)
+      continue;
+
+    app->TraceConnectWithoutContext("TransmittedInterests", MakeCallback(&KiteLatencyTracer::AppSentInterest, this));
+    app->TraceConnectWithoutContext("ReceivedInterests", MakeCallback(&KiteLatencyTracer::AppReceivedInterest, this));
+    app->TraceConnectWithoutContext("ReceivedDatas", MakeCallback(&KiteLatencyTracer::AppReceivedData, this));
+  }
+
+  Ptr<L3Protocol> l3 = node->GetObject<L3Protocol>();
+  l3->TraceConnectWithoutContext("InInterests", MakeCallback(&KiteLatencyTracer::InInterests, this));
+  l3->TraceConnectWithoutContext("InData", MakeCallback(&KiteLatencyTracer::InData, this));
+}
+
+void
+KiteLatencyTracer::PrintHeader(std::ostream& os) const
+{
+  os << "Time"
+     << "\t"
+     << "Node"
+     << "\t"
+     << "Name"
+     << "\t"
+     << "Total"
+     << "\t"
+     << "Request"
+     << "\t"
+     << "Server"
+     << "\t"
+     << "Tracing"
+     << "\t"
+     << "Data"
+     << "\t"
+     << "Hops";
+}
+
+void
+KiteLatencyTracer::PrintHopHeader(std::ostream& os) const
+{
+  os << "Time"
+     << "\t"
+     << "Name"
+     << "\t"
+     << "Node"
+     << "\t"
+     << "Packet"
+     << "\t"
+     << "Offset";
+}
+
+void
+KiteLatencyTracer::AppSentInterest(shared_ptr<const Interest> interest, Ptr<App>, shared_ptr<Face>)
+{
+  ExpireEntries();
+
+  Time expiry = Simulator::Now() + MilliSeconds(interest->getInterestLifetime().count());
+  if (interest->getTraceFlag() == 1) {
+    Request& request = g_requests[interest->getName()];
+    request.sent = Simulator::Now();
+    request.arrived = Time(0);
+    request.expiry = expiry;
+    g_expiries.insert(std::make_pair(expiry, std::make_pair(interest->getName(), false)));
+  }
+  else if (interest->getTraceFlag() == 2 && interest->hasTraceName()) {
+    // a new tracing Interest for the segment, either the first or a retransmission: start over
+    Segment& segment = g_segments[interest->getName()];
+    segment = Segment();
+    segment.tracingSent = Simulator::Now();
+    segment.expiry = expiry;
+    g_expiries.insert(std::make_pair(expiry, std::make_pair(interest->getName(), true)));
+
+    auto request = g_requests.find(interest->getTraceName());
+    if (request != g_requests.end() && !request->second.arrived.IsZero()) {
+      segment.requestSent = request->second.sent;
+      segment.requestArrived = request->second.arrived;
+    }
+  }
+}
+
+void
+KiteLatencyTracer::AppReceivedInterest(shared_ptr<const Interest> interest, Ptr<App>, shared_ptr<Face>)
+{
+  if (interest->getTraceFlag() == 1) {
+    auto request = g_requests.find(interest->getName());
+    if (request != g_requests.end() && request->second.arrived.IsZero()) {
+      request->second.arrived = Simulator::Now();
+    }
+  }
+  else if (interest->getTraceFlag() == 2) {
+    auto segment = g_segments.find(interest->getName());
+    if (segment != g_segments.end() && segment->second.tracingArrived.IsZero()) {
+      segment->second.tracingArrived = Simulator::Now();
+    }
+  }
+}
+
+void
+KiteLatencyTracer::AppReceivedData(shared_ptr<const Data> data, Ptr<App>, shared_ptr<Face>)
+{
+  auto item = g_segments.find(data->getName());
+  if (item == g_segments.end() || item->second.tracingArrived.IsZero())
+    return;
+
+  const Segment& segment = item->second;
+  Time now = Simulator::Now();
+
+  Time tracing = segment.tracingArrived - segment.tracingSent;
+  Time dataLeg = now - segment.tracingArrived;
+  Time request = segment.requestArrived - segment.requestSent;
+  Time server = segment.tracingSent - segment.requestArrived;
+  Time total = segment.requestSent.IsZero() ? tracing + dataLeg : now - segment.requestSent;
+
+  *m_os << now.ToDouble(Time::S) << "\t" << m_node << "\t" << data->getName() << "\t"
+        << total.ToDouble(Time::S) << "\t";
+  if (segment.requestSent.IsZero()) {
+    *m_os << "-\t-\t"; // the request that set up the trace was not seen
+  }
+  else {
+    *m_os << request.ToDouble(Time::S) << "\t" << server.ToDouble(Time::S) << "\t";
+  }
+  *m_os << tracing.ToDouble(Time::S) << "\t" << dataLeg.ToDouble(Time::S) << "\t"
+        << segment.hops.size() << "\n";
+
+  if (m_hopOs != nullptr) {
+    for (const auto& hop : segment.hops) {
+      *m_hopOs << now.ToDouble(Time::S) << "\t" << data->getName() << "\t" << std::get<0>(hop) << "\t"
+               << std::get<1>(hop) << "\t" << std::get<2>(hop).ToDouble(Time::S) << "\n";
+    }
+  }
+
+  g_segments.erase(item);
+}
+
+void
+KiteLatencyTracer::InInterests(const Interest& interest, const Face& face)
+{
+  if (interest.getTraceFlag() != 2)
+    return;
+
+  auto segment = g_segments.find(interest.getName());
+  if (segment != g_segments.end()) {
+    segment->second.hops.push_back(std::make_tuple(m_node, std::string("Tracing"),
+                                                   Simulator::Now() - segment->second.tracingSent));
+  }
+}
+
+void
+KiteLatencyTracer::InData(const Data& data, const Face& face)
+{
+  auto segment = g_segments.find(data.getName());
+  if (segment != g_segments.end()) {
+    segment->second.hops.push_back(std::make_tuple(m_node, std::string("Data"),
+                                                   Simulator::Now() - segment->second.tracingSent));
+  }
+}
+
+} // namespace ndn
+} // namespace ns3
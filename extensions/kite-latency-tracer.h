@@ -0,0 +1,117 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NDN_KITE_LATENCY_TRACER_H
+#define NDN_KITE_LATENCY_TRACER_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/ndnSIM/NFD/daemon/face/face.hpp"
+
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/simple-ref-count.h"
+
+#include <fstream>
+
+namespace ns3 {
+namespace ndn {
+
+class App;
+
+/**
+ * @ingroup ndn-tracers
+ * @brief Measures the end-to-end latency of Kite uploads, from the mobile's traced Interest
+ * to the arrival of the uploaded Data at the server, and breaks it down per hop
+ *
+ * Every uploaded segment goes through four legs, each written in its own column:
+ * - Request: the traced Interest (TraceFlag 1) from the mobile application to the server application;
+ * - Server: from its arrival until the server sends the tracing Interest (TraceFlag 2) for the segment;
+ * - Tracing: the tracing Interest along the trace, through the anchor and access point, to the mobile;
+ * - Data: the Data back from the mobile to the server.
+ * The optional hop file has one row per node the tracing Interest and the Data went through,
+ * with the time elapsed since the tracing Interest was sent, so that the share of every access point,
+ * anchor or router is visible.  Nodes are shown by their ns-3 name if they have one.
+ *
+ * Forwarders do not carry packet tags over links in ndnSIM, so instead of stamping packets the tracer
+ * keeps the origin times in a table shared by all nodes, keyed by the traced Interest name
+ * and by the segment name.  Entries are dropped once the lifetime of their Interest is over,
+ * since no Data can answer it any more.  Tracers hook into the applications present on the nodes,
+ * so they are installed after the applications.
+ */
+class KiteLatencyTracer : public SimpleRefCount<KiteLatencyTracer> {
+public:
+  /**
+   * @brief Helper method to install tracers on all simulation nodes
+   *
+   * @param file    File to which per-segment latencies will be written.  If filename is -, then std::out is used
+   * @param hopFile File to which per-hop times will be written, "" to disable
+   */
+  static void
+  InstallAll(const std::string& file, const std::string& hopFile = "");
+
+  /**
+   * @brief Helper method to install tracers on the selected simulation nodes
+   *
+   * Hops are only reported for the selected nodes.
+   */
+  static void
+  Install(const NodeContainer& nodes, const std::string& file, const std::string& hopFile = "");
+
+  /**
+   * @brief Explicit request to remove all statically created tracers
+   */
+  static void
+  Destroy();
+
+  KiteLatencyTracer(shared_ptr<std::ostream> os, shared_ptr<std::ostream> hopOs, Ptr<Node> node);
+
+  void
+  PrintHeader(std::ostream& os) const;
+
+  void
+  PrintHopHeader(std::ostream& os) const;
+
+private:
+  void
+  AppSentInterest(shared_ptr<const Interest> interest, Ptr<App> app, shared_ptr<Face> face);
+
+  void
+  AppReceivedInterest(shared_ptr<const Interest> interest, Ptr<App> app, shared_ptr<Face> face);
+
+  void
+  AppReceivedData(shared_ptr<const Data> data, Ptr<App> app, shared_ptr<Face> face);
+
+  void
+  InInterests(const Interest& interest, const Face& face);
+
+  void
+  InData(const Data& data, const Face& face);
+
+private:
+  shared_ptr<std::ostream> m_os;
+  shared_ptr<std::ostream> m_hopOs;
+  Ptr<Node> m_nodePtr;
+  std::string m_node;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_KITE_LATENCY_TRACER_H
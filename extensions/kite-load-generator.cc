@@ -0,0 +1,250 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "kite-load-generator.h"
+#include "ndn-kite-upload-server.h"
+
+#include "ns3/log.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+
+#include "helper/ndn-fib-helper.hpp"
+
+NS_LOG_COMPONENT_DEFINE("ndn.kite.KiteLoadGenerator");
+
+namespace ns3 {
+namespace ndn {
+
+NS_OBJECT_ENSURE_REGISTERED(KiteLoadGenerator);
+
+TypeId
+KiteLoadGenerator::GetTypeId(void)
+{
+  static TypeId tid =
+    TypeId("ns3::ndn::KiteLoadGenerator")
+      .SetGroupName("Ndn")
+      .SetParent<App>()
+      .AddConstructor<KiteLoadGenerator>()
+
+      .AddAttribute("Mode", "Behavior of the virtual mobiles: upload (default) or pull",
+                    StringValue("upload"),
+                    MakeStringAccessor(&KiteLoadGenerator::SetMode, &KiteLoadGenerator::GetMode),
+                    MakeStringChecker())
+      .AddAttribute("ServerPrefix", "Name of the upload server", StringValue("/"),
+                    MakeNameAccessor(&KiteLoadGenerator::m_serverPrefix), MakeNameChecker())
+      .AddAttribute("AnchorPrefix", "Name of the anchor in pull mode", StringValue("/"),
+                    MakeNameAccessor(&KiteLoadGenerator::m_anchorPrefix), MakeNameChecker())
+      .AddAttribute("MobilePrefix", "Common prefix of the virtual mobiles", StringValue("/vmobile"),
+                    MakeNameAccessor(&KiteLoadGenerator::m_mobilePrefix), MakeNameChecker())
+      .AddAttribute("MobileCount", "Number of virtual mobiles", UintegerValue(1000),
+                    MakeUintegerAccessor(&KiteLoadGenerator::m_mobileCount), MakeUintegerChecker<uint32_t>())
+      .AddAttribute("TraceInterval", "Interval between two traced Interests of a virtual mobile", StringValue("1s"),
+                    MakeTimeAccessor(&KiteLoadGenerator::m_traceInterval), MakeTimeChecker())
+      .AddAttribute("InterestLifeTime", "LifeTime for traced Interest packet", StringValue("0.9s"),
+                    MakeTimeAccessor(&KiteLoadGenerator::m_interestLifeTime), MakeTimeChecker())
+      .AddAttribute("ObjectSize", "Number of segments every virtual mobile uploads, 0 for an endless stream",
+                    UintegerValue(0),
+                    MakeUintegerAccessor(&KiteLoadGenerator::m_objectSize), MakeUintegerChecker<uint32_t>())
+      .AddAttribute("PayloadSize", "Virtual payload size for Content packets", UintegerValue(1024),
+                    MakeUintegerAccessor(&KiteLoadGenerator::m_payloadSize), MakeUintegerChecker<uint32_t>())
+      .AddAttribute("ShardCount", "Number of server shards, 0 if the server is not sharded",
+                    UintegerValue(0),
+                    MakeUintegerAccessor(&KiteLoadGenerator::m_shardCount), MakeUintegerChecker<uint32_t>())
+      .AddAttribute("RequestSecret", "Secret shared with the server to derive request tokens, 0 to send no token",
+                    UintegerValue(0),
+                    MakeUintegerAccessor(&KiteLoadGenerator::m_requestSecret), MakeUintegerChecker<uint32_t>())
+    ;
+  return tid;
+}
+
+KiteLoadGenerator::VirtualMobile::VirtualMobile()
+  : traces(0)
+  , tracings(0)
+{
+}
+
+KiteLoadGenerator::KiteLoadGenerator()
+  : m_pull(false)
+  , m_mobileCount(1000)
+  , m_objectSize(0)
+  , m_payloadSize(1024)
+  , m_shardCount(0)
+  , m_requestSecret(0)
+  , m_rand(CreateObject<UniformRandomVariable>())
+{
+  NS_LOG_FUNCTION_NOARGS();
+}
+
+void
+KiteLoadGenerator::SetMode(const std::string& value)
+{
+  if (value == "upload") {
+    m_pull = false;
+  }
+  else if (value == "pull") {
+    m_pull = true;
+  }
+  else {
+    NS_FATAL_ERROR("Mode " << value << " is not supported, use upload or pull");
+  }
+}
+
+std::string
+KiteLoadGenerator::GetMode() const
+{
+  return m_pull ? "pull" : "upload";
+}
+
+void
+KiteLoadGenerator::StartApplication()
+{
+  NS_LOG_FUNCTION_NOARGS();
+  App::StartApplication();
+
+  // one route covers the tracing Interests of all virtual mobiles
+  FibHelper::AddRoute(GetNode(), m_mobilePrefix, m_face, 0);
+
+  m_mobiles.assign(m_mobileCount, VirtualMobile());
+  for (uint32_t mobile = 0; mobile < m_mobileCount; mobile++) {
+    Time offset = Seconds(m_rand->GetValue(0, m_traceInterval.GetSeconds()));
+    m_mobiles[mobile].traceEvent = Simulator::Schedule(offset, &KiteLoadGenerator::SendTrace, this, mobile);
+  }
+}
+
+void
+KiteLoadGenerator::StopApplication()
+{
+  NS_LOG_FUNCTION_NOARGS();
+
+  uint64_t traces = 0;
+  uint64_t tracings = 0;
+  for (auto& mobile : m_mobiles) {
+    Simulator::Cancel(mobile.traceEvent);
+    traces += mobile.traces;
+    tracings += mobile.tracings;
+  }
+
+  NS_LOG_INFO("node(" << GetNode()->GetId() << ") " << m_mobiles.size() << " virtual mobiles sent "
+              << traces << " traced Interests and received " << tracings << " tracing Interests");
+
+  App::StopApplication();
+}
+
+Name
+KiteLoadGenerator::GetMobilePrefix(uint32_t mobile) const
+{
+  return Name(m_mobilePrefix).appendNumber(mobile);
+}
+
+Name
+KiteLoadGenerator::GetTraceName(uint32_t mobile) const
+{
+  Name mobilePrefix = GetMobilePrefix(mobile);
+
+  if (m_pull) {
+    return Name(m_anchorPrefix).append(mobilePrefix);
+  }
+
+  // same layout as KiteUploadMobile::GetRequestName()
+  Name name(m_serverPrefix);
+  if (m_shardCount > 0) {
+    name.append(std::to_string(KiteUploadServer::GetShard(mobilePrefix, m_shardCount)));
+  }
+  name.append(mobilePrefix);
+  if (m_requestSecret != 0) {
+    name.append("token").appendNumber(KiteUploadServer::MakeRequestToken(mobilePrefix, m_requestSecret,
+                                                                         Simulator::Now()));
+  }
+  if (m_objectSize > 0) {
+    name.append("bulk").appendNumber(m_objectSize);
+  }
+  return name;
+}
+
+void
+KiteLoadGenerator::SendTrace(uint32_t mobile)
+{
+  if (!m_active)
+    return;
+
+  VirtualMobile& state = m_mobiles[mobile];
+  state.traceEvent = Simulator::Schedule(m_traceInterval, &KiteLoadGenerator::SendTrace, this, mobile);
+  state.traces++;
+
+  shared_ptr<Interest> interest = make_shared<Interest>();
+  interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+  interest->setName(GetTraceName(mobile));
+  interest->setTraceFlag(1);
+  time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
+  interest->setInterestLifetime(interestLifeTime);
+
+  NS_LOG_DEBUG("> Traced Interest of virtual mobile " << mobile << ": " << interest->getName());
+
+  m_transmittedInterests(interest, this, m_face);
+  m_appLink->onReceiveInterest(*interest);
+}
+
+void
+KiteLoadGenerator::OnInterest(shared_ptr<const Interest> interest)
+{
+  App::OnInterest(interest); // tracing inside
+
+  if (!m_active)
+    return;
+
+  // <MobilePrefix>/<mobile>/<seq>
+  const Name& name = interest->getName();
+  if (name.size() < m_mobilePrefix.size() + 2 || !m_mobilePrefix.isPrefixOf(name)
+      || !name.get(m_mobilePrefix.size()).isNumber())
+    return;
+
+  uint32_t mobile = name.get(m_mobilePrefix.size()).toNumber();
+  if (mobile >= m_mobiles.size())
+    return;
+
+  VirtualMobile& state = m_mobiles[mobile];
+  state.tracings++;
+
+  if (m_pull)
+    return; // KitePullMobile does not answer either
+
+  auto data = make_shared<Data>();
+  data->setName(name);
+  data->setFreshnessPeriod(::ndn::time::milliseconds(0));
+  data->setContent(make_shared< ::ndn::Buffer>(m_payloadSize));
+
+  Signature signature;
+  SignatureInfo signatureInfo(static_cast< ::ndn::tlv::SignatureTypeValue>(255));
+  signature.setInfo(signatureInfo);
+  signature.setValue(::ndn::makeNonNegativeIntegerBlock(::ndn::tlv::SignatureValue, 0));
+  data->setSignature(signature);
+
+  NS_LOG_DEBUG("node(" << GetNode()->GetId() << ") virtual mobile " << mobile << " responding with Data: "
+               << data->getName());
+
+  data->wireEncode();
+
+  m_transmittedDatas(data, this, m_face);
+  m_appLink->onReceiveData(*data);
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,126 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NDN_KITE_LOAD_GENERATOR_H
+#define NDN_KITE_LOAD_GENERATOR_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "ns3/ndnSIM/apps/ndn-app.hpp"
+
+#include "ns3/random-variable-stream.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-apps
+ * @brief Ndn application that runs MobileCount virtual mobiles on a single node, to load servers and the
+ * trace strategy with many mobiles without simulating a radio and a stack for each of them
+ *
+ * Virtual mobile i is named <MobilePrefix>/<i> and behaves on the wire like one mobile application:
+ * - in upload mode (default), like KiteUploadMobile: it sends a traced Interest named
+ *   <ServerPrefix>[/<shard>]/<MobilePrefix>/<i>[/token/<token>][/bulk/<ObjectSize>] every TraceInterval,
+ *   and answers tracing Interests for <MobilePrefix>/<i>/<seq> with PayloadSize bytes of content;
+ * - in pull mode, like KitePullMobile: it sends a traced Interest named <AnchorPrefix>/<MobilePrefix>/<i>
+ *   every TraceInterval, and only counts the tracing Interests it receives.
+ *
+ * Every virtual mobile starts at a random offset within the first TraceInterval, so that their traces
+ * are not refreshed all at once.  Traces of all virtual mobiles leave through the face of this node,
+ * they differ from real mobiles only in not moving.
+ */
+class KiteLoadGenerator : public App {
+public:
+  static TypeId
+  GetTypeId();
+
+  KiteLoadGenerator();
+
+  virtual void
+  OnInterest(shared_ptr<const Interest> interest);
+
+protected:
+  // inherited from Application base class.
+  virtual void
+  StartApplication();
+
+  virtual void
+  StopApplication();
+
+  /**
+   * @brief Send the traced Interest of the given virtual mobile and schedule its next one
+   */
+  void
+  SendTrace(uint32_t mobile);
+
+  /**
+   * @brief Prefix of the given virtual mobile, <MobilePrefix>/<mobile>
+   */
+  Name
+  GetMobilePrefix(uint32_t mobile) const;
+
+  /**
+   * @brief Name of the traced Interest of the given virtual mobile
+   */
+  Name
+  GetTraceName(uint32_t mobile) const;
+
+  void
+  SetMode(const std::string& value);
+
+  std::string
+  GetMode() const;
+
+private:
+  /**
+   * @brief State of one virtual mobile
+   */
+  struct VirtualMobile
+  {
+    VirtualMobile();
+
+    EventId traceEvent;
+    uint32_t traces;         ///< @brief traced Interests sent
+    uint32_t tracings;       ///< @brief tracing Interests received
+  };
+
+  bool m_pull;
+  Name m_serverPrefix;
+  Name m_anchorPrefix;
+  Name m_mobilePrefix;
+  uint32_t m_mobileCount;
+  Time m_traceInterval;
+  Time m_interestLifeTime;
+  uint32_t m_objectSize;   ///< @brief number of segments announced in upload mode, 0 for an endless stream
+  uint32_t m_payloadSize;
+  uint32_t m_shardCount;
+  uint32_t m_requestSecret;
+
+  Ptr<UniformRandomVariable> m_rand; ///< @brief nonce generator and start offsets
+  std::vector<VirtualMobile> m_mobiles;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_KITE_LOAD_GENERATOR_H
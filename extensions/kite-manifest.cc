@@ -0,0 +1,213 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "kite-manifest.h"
+
+#include <ndn-cxx/encoding/block-helpers.hpp>
+#include <ndn-cxx/encoding/encoding-buffer.hpp>
+#include <ndn-cxx/util/digest.hpp>
+
+#include <algorithm>
+#include <functional>
+
+namespace ns3 {
+namespace ndn {
+
+// 34 bytes per encoded digest, 6800 bytes of digests per manifest segment
+const uint32_t KiteManifest::DIGESTS_PER_SEGMENT = 200;
+
+KiteManifest::KiteManifest()
+  : m_segmentCount(0)
+  , m_segmentSize(0)
+{
+}
+
+KiteManifest::KiteManifest(const Name& objectName, uint32_t segmentCount, uint32_t segmentSize)
+  : m_objectName(objectName)
+  , m_segmentCount(segmentCount)
+  , m_segmentSize(segmentSize)
+{
+  m_digests.reserve(segmentCount);
+  for (uint32_t seq = 0; seq < segmentCount; seq++) {
+    shared_ptr< ::ndn::Buffer> content = makeSegmentContent(objectName, seq, segmentSize);
+    m_digests.push_back(::ndn::util::Sha256::computeDigest(content->get(), content->size()));
+  }
+}
+
+KiteManifest::KiteManifest(const Block& block)
+  : m_segmentCount(0)
+  , m_segmentSize(0)
+{
+  wireDecode(block);
+}
+
+Block
+KiteManifest::wireEncode(uint32_t manifestSegment) const
+{
+  ::ndn::EncodingBuffer encoder;
+
+  uint32_t first = std::min<uint32_t>(manifestSegment * DIGESTS_PER_SEGMENT, m_digests.size());
+  uint32_t last = std::min<uint32_t>(first + DIGESTS_PER_SEGMENT, m_digests.size());
+
+  size_t totalLength = 0;
+  for (uint32_t seq = last; seq > first; seq--) {
+    const ::ndn::ConstBufferPtr& digest = m_digests[seq - 1];
+    if (digest == nullptr) {
+      BOOST_THROW_EXCEPTION(::ndn::tlv::Error("KiteManifest segment has unknown digests"));
+    }
+    totalLength += ::ndn::prependByteArrayBlock(encoder, TLV_SEGMENT_DIGEST, digest->get(), digest->size());
+  }
+  totalLength += ::ndn::prependNonNegativeIntegerBlock(encoder, TLV_FIRST_SEGMENT, first);
+  totalLength += ::ndn::prependNonNegativeIntegerBlock(encoder, TLV_SEGMENT_SIZE, m_segmentSize);
+  totalLength += ::ndn::prependNonNegativeIntegerBlock(encoder, TLV_SEGMENT_COUNT, m_segmentCount);
+  totalLength += m_objectName.wireEncode(encoder);
+
+  totalLength += encoder.prependVarNumber(totalLength);
+  totalLength += encoder.prependVarNumber(TLV_KITE_MANIFEST);
+
+  return encoder.block();
+}
+
+void
+KiteManifest::wireDecode(const Block& block)
+{
+  if (block.type() != TLV_KITE_MANIFEST) {
+    BOOST_THROW_EXCEPTION(::ndn::tlv::Error("Expecting KiteManifest block"));
+  }
+
+  std::vector< ::ndn::ConstBufferPtr> digests;
+  uint32_t first = 0;
+  block.parse();
+
+  for (const Block& element : block.elements()) {
+    switch (element.type()) {
+    case ::ndn::tlv::Name:
+      m_objectName.wireDecode(element);
+      break;
+    case TLV_SEGMENT_COUNT:
+      m_segmentCount = ::ndn::readNonNegativeInteger(element);
+      break;
+    case TLV_SEGMENT_SIZE:
+      m_segmentSize = ::ndn::readNonNegativeInteger(element);
+      break;
+    case TLV_FIRST_SEGMENT:
+      first = ::ndn::readNonNegativeInteger(element);
+      break;
+    case TLV_SEGMENT_DIGEST:
+      digests.push_back(make_shared< ::ndn::Buffer>(element.value(), element.value_size()));
+      break;
+    default:
+      break;
+    }
+  }
+
+  if (first % DIGESTS_PER_SEGMENT != 0 || first > m_segmentCount
+      || digests.size() != std::min(DIGESTS_PER_SEGMENT, m_segmentCount - first)) {
+    BOOST_THROW_EXCEPTION(::ndn::tlv::Error("KiteManifest segment does not list a digest per segment it covers"));
+  }
+
+  m_digests.assign(m_segmentCount, nullptr);
+  std::copy(digests.begin(), digests.end(), m_digests.begin() + first);
+}
+
+bool
+KiteManifest::merge(const KiteManifest& other)
+{
+  if (other.m_objectName != m_objectName || other.m_segmentCount != m_segmentCount
+      || other.m_segmentSize != m_segmentSize)
+    return false;
+
+  for (uint32_t seq = 0; seq < m_segmentCount; seq++) {
+    if (m_digests[seq] == nullptr) {
+      m_digests[seq] = other.m_digests[seq];
+    }
+  }
+  return true;
+}
+
+uint32_t
+KiteManifest::getManifestSegmentCount() const
+{
+  return std::max<uint32_t>(1, (m_segmentCount + DIGESTS_PER_SEGMENT - 1) / DIGESTS_PER_SEGMENT);
+}
+
+bool
+KiteManifest::hasManifestSegment(uint32_t manifestSegment) const
+{
+  if (manifestSegment >= getManifestSegmentCount())
+    return false;
+
+  // every manifest segment lists its digests as a whole, and an empty object has an empty manifest segment 0
+  uint32_t first = manifestSegment * DIGESTS_PER_SEGMENT;
+  return first >= m_digests.size() || m_digests[first] != nullptr;
+}
+
+bool
+KiteManifest::isComplete() const
+{
+  for (uint32_t manifestSegment = 0; manifestSegment < getManifestSegmentCount(); manifestSegment++) {
+    if (!hasManifestSegment(manifestSegment))
+      return false;
+  }
+  return true;
+}
+
+bool
+KiteManifest::verifySegment(uint32_t seq, const uint8_t* content, size_t size) const
+{
+  if (seq >= m_digests.size() || m_digests[seq] == nullptr)
+    return false;
+
+  ::ndn::ConstBufferPtr digest = ::ndn::util::Sha256::computeDigest(content, size);
+  return *digest == *m_digests[seq];
+}
+
+Name
+KiteManifest::getManifestName(const Name& objectName, uint32_t manifestSegment)
+{
+  return Name(objectName).append("manifest").appendSegment(manifestSegment);
+}
+
+bool
+KiteManifest::parseManifestName(const Name& name, Name& objectName, uint32_t& manifestSegment)
+{
+  if (name.size() < 2 || name.get(-2) != ::ndn::name::Component("manifest") || !name.get(-1).isSegment())
+    return false;
+
+  objectName = name.getPrefix(-2);
+  manifestSegment = name.get(-1).toSegment();
+  return true;
+}
+
+shared_ptr< ::ndn::Buffer>
+KiteManifest::makeSegmentContent(const Name& objectName, uint32_t seq, uint32_t segmentSize)
+{
+  auto content = make_shared< ::ndn::Buffer>(segmentSize);
+
+  // cheap linear congruential filler, seeded by object and segment
+  uint32_t state = std::hash<std::string>()(objectName.toUri()) ^ (seq * 2654435761u);
+  for (uint8_t& byte : *content) {
+    state = state * 1664525u + 1013904223u;
+    byte = static_cast<uint8_t>(state >> 24);
+  }
+  return content;
+}
+
+} // namespace ndn
+} // namespace ns3
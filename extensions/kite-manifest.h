@@ -0,0 +1,162 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NDN_KITE_MANIFEST_H
+#define NDN_KITE_MANIFEST_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-apps
+ * @brief Manifest of a segmented object uploaded through Kite
+ *
+ * The manifest is published by the mobile before the object itself and tells the server
+ * how many segments to fetch and how to verify them:
+ *
+ *     KiteManifest ::= KITE-MANIFEST-TYPE TLV-LENGTH
+ *                        Name
+ *                        SegmentCount
+ *                        SegmentSize
+ *                        FirstSegment
+ *                        SegmentDigest*
+ *
+ * A digest list for a large object does not fit in one packet, so the manifest is itself segmented:
+ * manifest segment k lists the digests of DIGESTS_PER_SEGMENT object segments from FirstSegment on.
+ * Segments are named <object name>/<seq>, manifest segments <object name>/manifest/<k>.
+ * Segment content is generated deterministically from the object name and sequence number,
+ * so that both ends agree on the digests without carrying real payload.
+ */
+class KiteManifest {
+public:
+  enum {
+    TLV_KITE_MANIFEST = 200,
+    TLV_SEGMENT_COUNT = 201,
+    TLV_SEGMENT_SIZE = 202,
+    TLV_SEGMENT_DIGEST = 203,
+    TLV_FIRST_SEGMENT = 204
+  };
+
+  /**
+   * @brief Digests per manifest segment, keeping a manifest segment well under the 8800 bytes of an NDN packet
+   */
+  static const uint32_t DIGESTS_PER_SEGMENT;
+
+  KiteManifest();
+
+  /**
+   * @brief Build the manifest of an object, computing the digests of all its segments
+   */
+  KiteManifest(const Name& objectName, uint32_t segmentCount, uint32_t segmentSize);
+
+  /**
+   * @brief Decode one manifest segment, the digests of the other segments are unknown
+   */
+  explicit
+  KiteManifest(const Block& block);
+
+  /**
+   * @brief Encode the given segment of the manifest
+   */
+  Block
+  wireEncode(uint32_t manifestSegment) const;
+
+  void
+  wireDecode(const Block& block);
+
+  /**
+   * @brief Add the digests known to another part of the same manifest
+   * @returns false if the other part describes a different object
+   */
+  bool
+  merge(const KiteManifest& other);
+
+  /**
+   * @brief Number of segments of the manifest itself, at least 1
+   */
+  uint32_t
+  getManifestSegmentCount() const;
+
+  bool
+  hasManifestSegment(uint32_t manifestSegment) const;
+
+  /**
+   * @brief Whether the digests of all segments are known
+   */
+  bool
+  isComplete() const;
+
+  const Name&
+  getObjectName() const
+  {
+    return m_objectName;
+  }
+
+  uint32_t
+  getSegmentCount() const
+  {
+    return m_segmentCount;
+  }
+
+  uint32_t
+  getSegmentSize() const
+  {
+    return m_segmentSize;
+  }
+
+  /**
+   * @brief Check segment content against the digest listed in the manifest, false if the digest is unknown
+   */
+  bool
+  verifySegment(uint32_t seq, const uint8_t* content, size_t size) const;
+
+  /**
+   * @brief Name of one segment of the manifest of an object
+   */
+  static Name
+  getManifestName(const Name& objectName, uint32_t manifestSegment);
+
+  /**
+   * @brief Split the name of a manifest segment into object name and manifest segment
+   * @returns false if the name does not name a manifest segment
+   */
+  static bool
+  parseManifestName(const Name& name, Name& objectName, uint32_t& manifestSegment);
+
+  /**
+   * @brief Deterministic content of one segment of an object
+   */
+  static shared_ptr< ::ndn::Buffer>
+  makeSegmentContent(const Name& objectName, uint32_t seq, uint32_t segmentSize);
+
+private:
+  Name m_objectName;
+  uint32_t m_segmentCount;
+  uint32_t m_segmentSize;
+  std::vector< ::ndn::ConstBufferPtr> m_digests;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_KITE_MANIFEST_H
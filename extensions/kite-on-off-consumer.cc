@@ -0,0 +1,115 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "kite-on-off-consumer.h"
+
+#include "ns3/log.h"
+#include "ns3/string.h"
+#include "ns3/pointer.h"
+#include "ns3/simulator.h"
+
+NS_LOG_COMPONENT_DEFINE("ndn.kite.KiteOnOffConsumer");
+
+namespace ns3 {
+namespace ndn {
+
+NS_OBJECT_ENSURE_REGISTERED(KiteOnOffConsumer);
+
+TypeId
+KiteOnOffConsumer::GetTypeId(void)
+{
+  static TypeId tid =
+    TypeId("ns3::ndn::KiteOnOffConsumer")
+      .SetGroupName("Ndn")
+      .SetParent<ConsumerCbr>()
+      .AddConstructor<KiteOnOffConsumer>()
+
+      .AddAttribute("OnTime", "Duration of a sending period, in seconds",
+                    StringValue("ns3::ExponentialRandomVariable[Mean=0.5]"),
+                    MakePointerAccessor(&KiteOnOffConsumer::m_onTime),
+                    MakePointerChecker<RandomVariableStream>())
+      .AddAttribute("OffTime", "Duration of a silent period, in seconds",
+                    StringValue("ns3::ExponentialRandomVariable[Mean=0.5]"),
+                    MakePointerAccessor(&KiteOnOffConsumer::m_offTime),
+                    MakePointerChecker<RandomVariableStream>())
+    ;
+  return tid;
+}
+
+KiteOnOffConsumer::KiteOnOffConsumer()
+  : m_on(true)
+{
+  NS_LOG_FUNCTION_NOARGS();
+}
+
+void
+KiteOnOffConsumer::StartApplication()
+{
+  NS_LOG_FUNCTION_NOARGS();
+
+  m_on = true;
+  ConsumerCbr::StartApplication(); // schedules the first Interest
+  m_switchEvent = Simulator::Schedule(Seconds(m_onTime->GetValue()), &KiteOnOffConsumer::StopSending, this);
+}
+
+void
+KiteOnOffConsumer::StopApplication()
+{
+  NS_LOG_FUNCTION_NOARGS();
+
+  Simulator::Cancel(m_switchEvent);
+
+  ConsumerCbr::StopApplication();
+}
+
+void
+KiteOnOffConsumer::ScheduleNextPacket()
+{
+  if (!m_on)
+    return; // StartSending() resumes
+
+  ConsumerCbr::ScheduleNextPacket();
+}
+
+void
+KiteOnOffConsumer::StartSending()
+{
+  if (!m_active)
+    return;
+
+  NS_LOG_DEBUG("Burst starts");
+  m_on = true;
+  ScheduleNextPacket();
+  m_switchEvent = Simulator::Schedule(Seconds(m_onTime->GetValue()), &KiteOnOffConsumer::StopSending, this);
+}
+
+void
+KiteOnOffConsumer::StopSending()
+{
+  if (!m_active)
+    return;
+
+  NS_LOG_DEBUG("Burst ends");
+  m_on = false;
+  Simulator::Cancel(m_sendEvent);
+  m_switchEvent = Simulator::Schedule(Seconds(m_offTime->GetValue()), &KiteOnOffConsumer::StartSending, this);
+}
+
+} // namespace ndn
+} // namespace ns3
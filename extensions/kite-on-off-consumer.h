@@ -0,0 +1,76 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NDN_KITE_ON_OFF_CONSUMER_H
+#define NDN_KITE_ON_OFF_CONSUMER_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "ns3/ndnSIM/apps/ndn-consumer-cbr.hpp"
+
+#include "ns3/random-variable-stream.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-apps
+ * @brief ConsumerCbr that alternates between sending periods and silent periods, for bursty background traffic
+ *
+ * Like ns-3's OnOffApplication: it sends Interests at Frequency for OnTime, then stays silent for OffTime,
+ * both drawn again for every period.  The average rate is Frequency * E[OnTime] / (E[OnTime] + E[OffTime]).
+ */
+class KiteOnOffConsumer : public ConsumerCbr {
+public:
+  static TypeId
+  GetTypeId();
+
+  KiteOnOffConsumer();
+
+protected:
+  // inherited from Application base class.
+  virtual void
+  StartApplication();
+
+  virtual void
+  StopApplication();
+
+  virtual void
+  ScheduleNextPacket();
+
+private:
+  void
+  StartSending();
+
+  void
+  StopSending();
+
+private:
+  Ptr<RandomVariableStream> m_onTime;
+  Ptr<RandomVariableStream> m_offTime;
+  bool m_on;
+  EventId m_switchEvent;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_KITE_ON_OFF_CONSUMER_H
@@ -0,0 +1,299 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "kite-overhead-tracer.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/node-list.h"
+#include "ns3/callback.h"
+
+#include "ns3/ndnSIM/apps/ndn-app.hpp"
+#include "model/ndn-l3-protocol.hpp"
+
+#include <boost/lexical_cast.hpp>
+
+#include <list>
+#include <tuple>
+
+NS_LOG_COMPONENT_DEFINE("ndn.kite.KiteOverheadTracer");
+
+namespace ns3 {
+namespace ndn {
+
+static std::list<std::tuple<shared_ptr<std::ostream>, std::list<Ptr<KiteOverheadTracer>>>> g_tracers;
+
+void
+KiteOverheadTracer::Destroy()
+{
+  g_tracers.clear();
+}
+
+void
+KiteOverheadTracer::InstallAll(const std::string& file, Time period)
+{
+  NodeContainer nodes;
+  for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
+    nodes.Add(*node);
+  }
+
+  Install(nodes, file, period);
+}
+
+void
+KiteOverheadTracer::Install(const NodeContainer& nodes, const std::string& file, Time period)
+{
+  std::list<Ptr<KiteOverheadTracer>> tracers;
+  shared_ptr<std::ostream> outputStream;
+  if (file != "-") {
+    shared_ptr<std::ofstream> os(new std::ofstream());
+    os->open(file.c_str(), std::ios_base::out | std::ios_base::trunc);
+
+    if (!os->is_open()) {
+      NS_LOG_ERROR("File " << file << " cannot be opened for writing. Tracing disabled");
+      return;
+    }
+
+    outputStream = os;
+  }
+  else {
+    outputStream = shared_ptr<std::ostream>(&std::cout, std::bind([]{}));
+  }
+
+  for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); node++) {
+    if ((*node)->GetObject<L3Protocol>() == 0)
+      continue;
+
+    Ptr<KiteOverheadTracer> trace = Create<KiteOverheadTracer>(outputStream, *node);
+    trace->SetPeriod(period);
+    tracers.push_back(trace);
+  }
+
+  if (tracers.size() > 0) {
+    tracers.front()->PrintHeader(*outputStream);
+    *outputStream << "\n";
+  }
+
+  if (g_tracers.empty()) {
+    Simulator::ScheduleDestroy(&KiteOverheadTracer::Destroy);
+  }
+  g_tracers.push_back(std::make_tuple(outputStream, tracers));
+}
+
+void
+KiteOverheadTracer::PrintReport(std::ostream& os)
+{
+  Counters total;
+  uint64_t payloadBytes = 0;
+  for (const auto& item : g_tracers) {
+    for (const Ptr<KiteOverheadTracer>& tracer : std::get<1>(item)) {
+      for (int type = 0; type < PACKET_TYPES; type++) {
+        total.packets[type] += tracer->m_total.packets[type];
+        total.bytes[type] += tracer->m_total.bytes[type];
+      }
+      payloadBytes += tracer->m_payloadBytes;
+    }
+  }
+
+  uint64_t allBytes = 0;
+  os << "Type\tPackets\tBytes\n";
+  for (int type = 0; type < PACKET_TYPES; type++) {
+    os << GetTypeName(type) << "\t" << total.packets[type] << "\t" << total.bytes[type] << "\n";
+    allBytes += total.bytes[type];
+  }
+
+  uint64_t controlBytes = total.bytes[TRACED_INTEREST] + total.bytes[TRACED_DATA];
+  os << "\n"
+     << "PayloadBytes\t" << payloadBytes << "\n"
+     << "ControlBytes\t" << controlBytes << "\n"
+     << "ControlPerPayloadByte\t"
+     << (payloadBytes > 0 ? static_cast<double>(controlBytes) / payloadBytes : 0.0) << "\n"
+     << "BytesPerPayloadByte\t"
+     << (payloadBytes > 0 ? static_cast<double>(allBytes) / payloadBytes : 0.0) << "\n";
+}
+
+KiteOverheadTracer::Counters::Counters()
+{
+  for (int type = 0; type < PACKET_TYPES; type++) {
+    packets[type] = 0;
+    bytes[type] = 0;
+  }
+}
+
+KiteOverheadTracer::KiteOverheadTracer(shared_ptr<std::ostream> os, Ptr<Node> node)
+  : m_os(os)
+  , m_nodePtr(node)
+  , m_payloadBytes(0)
+{
+  Ptr<L3Protocol> l3 = node->GetObject<L3Protocol>();
+  l3->TraceConnectWithoutContext("InInterests", MakeCallback(&KiteOverheadTracer::InInterests, this));
+  l3->TraceConnectWithoutContext("OutInterests", MakeCallback(&KiteOverheadTracer::OutInterests, this));
+  l3->TraceConnectWithoutContext("OutData", MakeCallback(&KiteOverheadTracer::OutData, this));
+
+  for (uint32_t i = 0; i < node->GetNApplications(); i++) {
+    Ptr<App> app = DynamicCast<App>(node->GetApplication(i));
+    if (app == 0)
+      continue;
+
+    app->TraceConnectWithoutContext("ReceivedDatas", MakeCallback(&KiteOverheadTracer::AppReceivedData, this));
+  }
+}
+
+KiteOverheadTracer::~KiteOverheadTracer()
+{
+  m_printEvent.Cancel();
+}
+
+void
+KiteOverheadTracer::SetPeriod(const Time& period)
+{
+  m_period = period;
+  m_printEvent.Cancel();
+  if (m_period != Time(0)) {
+    m_printEvent = Simulator::Schedule(m_period, &KiteOverheadTracer::PeriodicPrinter, this);
+  }
+}
+
+void
+KiteOverheadTracer::PeriodicPrinter()
+{
+  Print(*m_os);
+  m_printEvent = Simulator::Schedule(m_period, &KiteOverheadTracer::PeriodicPrinter, this);
+}
+
+const char*
+KiteOverheadTracer::GetTypeName(int type)
+{
+  static const char* names[PACKET_TYPES] = {
+    "TracedInterests", "TracingInterests", "PlainInterests", "TracedData", "TracingData", "PlainData"
+  };
+  return names[type];
+}
+
+void
+KiteOverheadTracer::PrintHeader(std::ostream& os) const
+{
+  os << "Time"
+     << "\t"
+     << "Node"
+     << "\t"
+     << "FaceId"
+     << "\t"
+     << "FaceDescr"
+     << "\t"
+     << "Type"
+     << "\t"
+     << "Packets"
+     << "\t"
+     << "Bytes";
+}
+
+void
+KiteOverheadTracer::Print(std::ostream& os)
+{
+  for (const auto& item : m_faces) {
+    for (int type = 0; type < PACKET_TYPES; type++) {
+      os << Simulator::Now().ToDouble(Time::S) << "\t" << m_nodePtr->GetId() << "\t" << item.first << "\t"
+         << m_faceDescrs[item.first] << "\t" << GetTypeName(type) << "\t" << item.second.packets[type] << "\t"
+         << item.second.bytes[type] << "\n";
+    }
+  }
+  m_faces.clear();
+}
+
+void
+KiteOverheadTracer::InInterests(const Interest& interest, const Face& face)
+{
+  ExpireInterests();
+
+  int type = interest.getTraceFlag() == 1 ? TRACED_INTEREST
+           : interest.getTraceFlag() == 2 ? TRACING_INTEREST : PLAIN_INTEREST;
+  Time expiry = Simulator::Now() + MilliSeconds(interest.getInterestLifetime().count());
+  m_interests[interest.getName()] = std::make_pair(type, expiry);
+  m_expiries.insert(std::make_pair(expiry, interest.getName()));
+}
+
+void
+KiteOverheadTracer::ExpireInterests()
+{
+  Time now = Simulator::Now();
+  while (!m_expiries.empty() && m_expiries.begin()->first <= now) {
+    // an Interest received again since then has a later expiry of its own
+    auto interest = m_interests.find(m_expiries.begin()->second);
+    if (interest != m_interests.end() && interest->second.second <= now) {
+      m_interests.erase(interest);
+    }
+    m_expiries.erase(m_expiries.begin());
+  }
+}
+
+void
+KiteOverheadTracer::OutInterests(const Interest& interest, const Face& face)
+{
+  if (face.getScope() != ::ndn::nfd::FACE_SCOPE_NON_LOCAL)
+    return;
+
+  int type = interest.getTraceFlag() == 1 ? TRACED_INTEREST
+           : interest.getTraceFlag() == 2 ? TRACING_INTEREST : PLAIN_INTEREST;
+  Count(face, type, interest.wireEncode().size());
+}
+
+void
+KiteOverheadTracer::OutData(const Data& data, const Face& face)
+{
+  if (face.getScope() != ::ndn::nfd::FACE_SCOPE_NON_LOCAL)
+    return;
+
+  // Data of each class directly follows its Interests in PacketType
+  Count(face, GetInterestType(data.getName()) + TRACED_DATA, data.wireEncode().size());
+}
+
+void
+KiteOverheadTracer::AppReceivedData(shared_ptr<const Data> data, Ptr<App>, shared_ptr<Face>)
+{
+  m_payloadBytes += data->getContent().value_size();
+}
+
+void
+KiteOverheadTracer::Count(const Face& face, int type, size_t bytes)
+{
+  if (m_faceDescrs.count(face.getId()) == 0) {
+    m_faceDescrs[face.getId()] = boost::lexical_cast<std::string>(face.getLocalUri());
+  }
+
+  Counters& counters = m_faces[face.getId()];
+  counters.packets[type]++;
+  counters.bytes[type] += bytes;
+
+  m_total.packets[type]++;
+  m_total.bytes[type] += bytes;
+}
+
+int
+KiteOverheadTracer::GetInterestType(const Name& dataName) const
+{
+  for (size_t length = dataName.size() + 1; length > 0; length--) {
+    auto interest = m_interests.find(dataName.getPrefix(length - 1));
+    if (interest != m_interests.end())
+      return interest->second.first;
+  }
+  return PLAIN_INTEREST;
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,167 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NDN_KITE_OVERHEAD_TRACER_H
+#define NDN_KITE_OVERHEAD_TRACER_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/ndnSIM/NFD/daemon/face/face.hpp"
+
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/simple-ref-count.h"
+
+#include <fstream>
+#include <map>
+
+namespace ns3 {
+namespace ndn {
+
+class App;
+
+/**
+ * @ingroup ndn-tracers
+ * @brief Counts the bytes spent on Kite control traffic apart from the payload it delivers
+ *
+ * Every Interest sent over a non-local face is counted as traced (TraceFlag 1), tracing (TraceFlag 2)
+ * or plain, and every Data sent over a non-local face in the class of the Interest it answers.
+ * Every period one row is written per node, face and packet type with the packets and bytes sent,
+ * like L3RateTracer does.  Payload is the content of the Data received by the applications of the nodes,
+ * so tracers are installed after the applications.
+ *
+ * PrintReport() sums up the whole run over all tracers: control bytes are those of the traced Interests
+ * and of the Data answering them, which only exist to keep traces alive, and are given per byte of
+ * delivered payload, next to the bytes of all packets per byte of delivered payload.
+ */
+class KiteOverheadTracer : public SimpleRefCount<KiteOverheadTracer> {
+public:
+  /**
+   * @brief Helper method to install tracers on all simulation nodes
+   *
+   * @param file File to which traces will be written.  If filename is -, then std::out is used
+   * @param period How often the counters are written
+   */
+  static void
+  InstallAll(const std::string& file, Time period = Seconds(1.0));
+
+  /**
+   * @brief Helper method to install tracers on the selected simulation nodes
+   */
+  static void
+  Install(const NodeContainer& nodes, const std::string& file, Time period = Seconds(1.0));
+
+  /**
+   * @brief Explicit request to remove all statically created tracers
+   */
+  static void
+  Destroy();
+
+  /**
+   * @brief Write the totals of all installed tracers, to be called before Simulator::Destroy()
+   */
+  static void
+  PrintReport(std::ostream& os);
+
+  KiteOverheadTracer(shared_ptr<std::ostream> os, Ptr<Node> node);
+
+  ~KiteOverheadTracer();
+
+  void
+  PrintHeader(std::ostream& os) const;
+
+  void
+  SetPeriod(const Time& period);
+
+private:
+  enum PacketType {
+    TRACED_INTEREST,
+    TRACING_INTEREST,
+    PLAIN_INTEREST,
+    TRACED_DATA,
+    TRACING_DATA,
+    PLAIN_DATA,
+    PACKET_TYPES
+  };
+
+  struct Counters
+  {
+    Counters();
+
+    uint64_t packets[PACKET_TYPES];
+    uint64_t bytes[PACKET_TYPES];
+  };
+
+  static const char*
+  GetTypeName(int type);
+
+  void
+  PeriodicPrinter();
+
+  void
+  Print(std::ostream& os);
+
+  void
+  InInterests(const Interest& interest, const Face& face);
+
+  void
+  OutInterests(const Interest& interest, const Face& face);
+
+  void
+  OutData(const Data& data, const Face& face);
+
+  void
+  AppReceivedData(shared_ptr<const Data> data, Ptr<App> app, shared_ptr<Face> face);
+
+  void
+  Count(const Face& face, int type, size_t bytes);
+
+  /**
+   * @brief Class of the Interest a Data answers, by the longest name of an Interest received for it
+   */
+  int
+  GetInterestType(const Name& dataName) const;
+
+  /**
+   * @brief Forget the Interests whose lifetime is over, no Data can answer them any more
+   */
+  void
+  ExpireInterests();
+
+private:
+  shared_ptr<std::ostream> m_os;
+  Ptr<Node> m_nodePtr;
+
+  std::map<nfd::FaceId, Counters> m_faces;          ///< @brief counters of the current period
+  std::map<nfd::FaceId, std::string> m_faceDescrs;
+  Counters m_total;                                 ///< @brief counters of the whole run
+  uint64_t m_payloadBytes;                          ///< @brief content delivered to the applications
+
+  std::map<Name, std::pair<int, Time>> m_interests; ///< @brief type and expiry of the Interests received
+  std::multimap<Time, Name> m_expiries;             ///< @brief names of m_interests by expiry
+
+  Time m_period;
+  EventId m_printEvent;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_KITE_OVERHEAD_TRACER_H
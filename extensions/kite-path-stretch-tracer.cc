@@ -0,0 +1,289 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "kite-path-stretch-tracer.h"
+#include "kite-topology.h"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/node-list.h"
+#include "ns3/callback.h"
+
+#include "ns3/ndnSIM/apps/ndn-app.hpp"
+
+#include <ndn-cxx/lp/tags.hpp>
+
+#include <list>
+
+NS_LOG_COMPONENT_DEFINE("ndn.kite.KitePathStretchTracer");
+
+namespace ns3 {
+namespace ndn {
+
+static std::list<std::tuple<shared_ptr<std::ostream>, std::list<Ptr<KitePathStretchTracer>>>> g_tracers;
+
+namespace {
+
+/**
+ * @brief Sending node of a packet still on its way, until the lifetime of its Interest is over
+ */
+struct Sender
+{
+  uint32_t node;
+  Time expiry;
+};
+
+// packets still on their way, by name
+std::map<Name, Sender> g_interestSenders;
+std::map<Name, Sender> g_dataSenders;
+std::multimap<Time, std::pair<Name, bool>> g_expiries; ///< @brief expiry -> name, true for a Data
+
+/**
+ * @brief Forget the packets whose Interest expired unanswered, e.g. tracing Interests the mobile never answers
+ */
+void
+ExpireSenders()
+{
+  Time now = Simulator::Now();
+  while (!g_expiries.empty() && g_expiries.begin()->first <= now) {
+    std::map<Name, Sender>& senders = g_expiries.begin()->second.second ? g_dataSenders : g_interestSenders;
+    // a packet sent again since then has a later expiry of its own
+    auto sender = senders.find(g_expiries.begin()->second.first);
+    if (sender != senders.end() && sender->second.expiry <= now) {
+      senders.erase(sender);
+    }
+    g_expiries.erase(g_expiries.begin());
+  }
+}
+
+} // namespace
+
+void
+KitePathStretchTracer::Destroy()
+{
+  g_tracers.clear();
+  g_interestSenders.clear();
+  g_dataSenders.clear();
+  g_expiries.clear();
+}
+
+void
+KitePathStretchTracer::InstallAll(const std::string& file, Time period, double wirelessRange)
+{
+  NodeContainer nodes;
+  for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
+    nodes.Add(*node);
+  }
+
+  Install(nodes, file, period, wirelessRange);
+}
+
+void
+KitePathStretchTracer::Install(const NodeContainer& nodes, const std::string& file, Time period,
+                               double wirelessRange)
+{
+  std::list<Ptr<KitePathStretchTracer>> tracers;
+  shared_ptr<std::ostream> outputStream;
+  if (file != "-") {
+    shared_ptr<std::ofstream> os(new std::ofstream());
+    os->open(file.c_str(), std::ios_base::out | std::ios_base::trunc);
+
+    if (!os->is_open()) {
+      NS_LOG_ERROR("File " << file << " cannot be opened for writing. Tracing disabled");
+      return;
+    }
+
+    outputStream = os;
+  }
+  else {
+    outputStream = shared_ptr<std::ostream>(&std::cout, std::bind([]{}));
+  }
+
+  for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); node++) {
+    Ptr<KitePathStretchTracer> trace = Create<KitePathStretchTracer>(outputStream, *node, wirelessRange);
+    trace->SetPeriod(period);
+    tracers.push_back(trace);
+  }
+
+  if (tracers.size() > 0) {
+    tracers.front()->PrintHeader(*outputStream);
+    *outputStream << "\n";
+  }
+
+  if (g_tracers.empty()) {
+    Simulator::ScheduleDestroy(&KitePathStretchTracer::Destroy);
+  }
+  g_tracers.push_back(std::make_tuple(outputStream, tracers));
+}
+
+KitePathStretchTracer::Flow::Flow()
+  : packets(0)
+  , actualHops(0)
+  , shortestHops(0)
+{
+}
+
+KitePathStretchTracer::KitePathStretchTracer(shared_ptr<std::ostream> os, Ptr<Node> node, double wirelessRange)
+  : m_os(os)
+  , m_nodePtr(node)
+  , m_wirelessRange(wirelessRange)
+{
+  for (uint32_t i = 0; i < node->GetNApplications(); i++) {
+    Ptr<App> app = DynamicCast<App>(node->GetApplication(i));
+    if (app == 0)
+      continue;
+
+    app->TraceConnectWithoutContext("TransmittedInterests", MakeCallback(&KitePathStretchTracer::AppSentInterest, this));
+    app->TraceConnectWithoutContext("TransmittedDatas", MakeCallback(&KitePathStretchTracer::AppSentData, this));
+    app->TraceConnectWithoutContext("ReceivedInterests", MakeCallback(&KitePathStretchTracer::AppReceivedInterest, this));
+    app->TraceConnectWithoutContext("ReceivedDatas", MakeCallback(&KitePathStretchTracer::AppReceivedData, this));
+  }
+}
+
+KitePathStretchTracer::~KitePathStretchTracer()
+{
+  m_printEvent.Cancel();
+}
+
+void
+KitePathStretchTracer::SetPeriod(const Time& period)
+{
+  m_period = period;
+  m_printEvent.Cancel();
+  if (m_period != Time(0)) {
+    m_printEvent = Simulator::Schedule(m_period, &KitePathStretchTracer::PeriodicPrinter, this);
+  }
+}
+
+void
+KitePathStretchTracer::PeriodicPrinter()
+{
+  Print(*m_os);
+  m_printEvent = Simulator::Schedule(m_period, &KitePathStretchTracer::PeriodicPrinter, this);
+}
+
+void
+KitePathStretchTracer::PrintHeader(std::ostream& os) const
+{
+  os << "Time"
+     << "\t"
+     << "From"
+     << "\t"
+     << "To"
+     << "\t"
+     << "Type"
+     << "\t"
+     << "Packets"
+     << "\t"
+     << "ActualHops"
+     << "\t"
+     << "ShortestHops"
+     << "\t"
+     << "Stretch";
+}
+
+void
+KitePathStretchTracer::Print(std::ostream& os)
+{
+  for (const auto& item : m_flows) {
+    const Flow& flow = item.second;
+    double actual = static_cast<double>(flow.actualHops) / flow.packets;
+    double shortest = static_cast<double>(flow.shortestHops) / flow.packets;
+
+    os << Simulator::Now().ToDouble(Time::S) << "\t" << std::get<0>(item.first) << "\t" << m_nodePtr->GetId()
+       << "\t" << std::get<1>(item.first) << "\t" << flow.packets << "\t" << actual << "\t" << shortest << "\t"
+       << (shortest > 0 ? actual / shortest : 1.0) << "\n";
+  }
+  m_flows.clear();
+}
+
+void
+KitePathStretchTracer::AppSentInterest(shared_ptr<const Interest> interest, Ptr<App>, shared_ptr<Face>)
+{
+  ExpireSenders();
+
+  if (interest->getTraceFlag() == 1 || interest->getTraceFlag() == 2) {
+    Time expiry = Simulator::Now() + MilliSeconds(interest->getInterestLifetime().count());
+    g_interestSenders[interest->getName()] = Sender{m_nodePtr->GetId(), expiry};
+    g_expiries.insert(std::make_pair(expiry, std::make_pair(interest->getName(), false)));
+  }
+}
+
+void
+KitePathStretchTracer::AppSentData(shared_ptr<const Data> data, Ptr<App>, shared_ptr<Face>)
+{
+  // only Data answering a tracing Interest is of interest
+  auto sender = g_dataSenders.find(data->getName());
+  if (sender != g_dataSenders.end()) {
+    sender->second.node = m_nodePtr->GetId();
+  }
+}
+
+void
+KitePathStretchTracer::AppReceivedInterest(shared_ptr<const Interest> interest, Ptr<App>, shared_ptr<Face>)
+{
+  auto sender = g_interestSenders.find(interest->getName());
+  if (sender == g_interestSenders.end())
+    return;
+
+  shared_ptr<lp::HopCountTag> hopCount = interest->getTag<lp::HopCountTag>();
+  if (hopCount != nullptr) {
+    Count(sender->second.node, interest->getTraceFlag() == 1 ? "Traced" : "Tracing", *hopCount);
+  }
+
+  if (interest->getTraceFlag() == 2) {
+    // until the Data is actually sent
+    Time expiry = Simulator::Now() + MilliSeconds(interest->getInterestLifetime().count());
+    g_dataSenders[interest->getName()] = Sender{m_nodePtr->GetId(), expiry};
+    g_expiries.insert(std::make_pair(expiry, std::make_pair(interest->getName(), true)));
+  }
+  g_interestSenders.erase(sender);
+}
+
+void
+KitePathStretchTracer::AppReceivedData(shared_ptr<const Data> data, Ptr<App>, shared_ptr<Face>)
+{
+  auto sender = g_dataSenders.find(data->getName());
+  if (sender == g_dataSenders.end())
+    return;
+
+  shared_ptr<lp::HopCountTag> hopCount = data->getTag<lp::HopCountTag>();
+  if (hopCount != nullptr) {
+    Count(sender->second.node, "Data", *hopCount);
+  }
+  g_dataSenders.erase(sender);
+}
+
+void
+KitePathStretchTracer::Count(uint32_t sender, const std::string& type, int hopCount)
+{
+  int shortest = KiteTopology::GetHopCount(NodeList::GetNode(sender), m_nodePtr, m_wirelessRange);
+  if (shortest < 0) {
+    NS_LOG_DEBUG("No path from node " << sender << " to node " << m_nodePtr->GetId() << " any more");
+    return;
+  }
+
+  Flow& flow = m_flows[std::make_tuple(sender, type)];
+  flow.packets++;
+  flow.actualHops += hopCount;
+  flow.shortestHops += shortest;
+}
+
+} // namespace ndn
+} // namespace ns3
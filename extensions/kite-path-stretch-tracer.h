@@ -0,0 +1,133 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NDN_KITE_PATH_STRETCH_TRACER_H
+#define NDN_KITE_PATH_STRETCH_TRACER_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/simple-ref-count.h"
+
+#include <fstream>
+#include <map>
+#include <tuple>
+
+namespace ns3 {
+namespace ndn {
+
+class App;
+
+/**
+ * @ingroup ndn-tracers
+ * @brief Compares the hops Kite packets actually take with the shortest path between their endpoints
+ *
+ * Traced Interests (TraceFlag 1), tracing Interests (TraceFlag 2) and the Data answering them
+ * are counted when they reach an application.  Their actual hop count is the HopCountTag the link services
+ * of ndnSIM increment on every link, the shortest one is computed by KiteTopology on the topology
+ * at the time of arrival, with the mobiles where they are at that moment.
+ *
+ * Every period one row is written per flow, that is per sending node, receiving node and packet type,
+ * with the number of packets, the mean actual and shortest hop counts and their ratio, the path stretch.
+ * Tracers hook into the applications present on the nodes, so they are installed after the applications.
+ */
+class KitePathStretchTracer : public SimpleRefCount<KitePathStretchTracer> {
+public:
+  /**
+   * @brief Helper method to install tracers on all simulation nodes
+   *
+   * @param file File to which traces will be written.  If filename is -, then std::out is used
+   * @param period How often the flows are written
+   * @param wirelessRange Range of the wifi radios in meters, see KiteTopology
+   */
+  static void
+  InstallAll(const std::string& file, Time period = Seconds(1.0), double wirelessRange = 110.0);
+
+  /**
+   * @brief Helper method to install tracers on the selected simulation nodes
+   */
+  static void
+  Install(const NodeContainer& nodes, const std::string& file, Time period = Seconds(1.0),
+          double wirelessRange = 110.0);
+
+  /**
+   * @brief Explicit request to remove all statically created tracers
+   */
+  static void
+  Destroy();
+
+  KitePathStretchTracer(shared_ptr<std::ostream> os, Ptr<Node> node, double wirelessRange);
+
+  ~KitePathStretchTracer();
+
+  void
+  PrintHeader(std::ostream& os) const;
+
+  void
+  SetPeriod(const Time& period);
+
+private:
+  void
+  PeriodicPrinter();
+
+  void
+  Print(std::ostream& os);
+
+  void
+  AppSentInterest(shared_ptr<const Interest> interest, Ptr<App> app, shared_ptr<Face> face);
+
+  void
+  AppSentData(shared_ptr<const Data> data, Ptr<App> app, shared_ptr<Face> face);
+
+  void
+  AppReceivedInterest(shared_ptr<const Interest> interest, Ptr<App> app, shared_ptr<Face> face);
+
+  void
+  AppReceivedData(shared_ptr<const Data> data, Ptr<App> app, shared_ptr<Face> face);
+
+  void
+  Count(uint32_t sender, const std::string& type, int hopCount);
+
+private:
+  struct Flow
+  {
+    Flow();
+
+    uint32_t packets;
+    uint64_t actualHops;
+    uint64_t shortestHops;
+  };
+
+  shared_ptr<std::ostream> m_os;
+  Ptr<Node> m_nodePtr;
+  double m_wirelessRange;
+
+  std::map<std::tuple<uint32_t, std::string>, Flow> m_flows; ///< @brief by sending node and packet type
+
+  Time m_period;
+  EventId m_printEvent;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_KITE_PATH_STRETCH_TRACER_H
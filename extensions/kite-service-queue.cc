@@ -0,0 +1,144 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "kite-service-queue.h"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/pointer.h"
+#include "ns3/trace-source-accessor.h"
+
+NS_LOG_COMPONENT_DEFINE("ndn.kite.KiteServiceQueue");
+
+namespace ns3 {
+namespace ndn {
+
+NS_OBJECT_ENSURE_REGISTERED(KiteServiceQueue);
+
+TypeId
+KiteServiceQueue::GetTypeId(void)
+{
+  static TypeId tid =
+    TypeId("ns3::ndn::KiteServiceQueue")
+      .SetGroupName("Ndn")
+      .SetParent<Object>()
+      .AddConstructor<KiteServiceQueue>()
+
+      .AddAttribute("ServiceTime", "Random variable of the service time of one job, in seconds",
+                    StringValue("ns3::ConstantRandomVariable[Constant=0.001]"),
+                    MakePointerAccessor(&KiteServiceQueue::m_serviceTime),
+                    MakePointerChecker<RandomVariableStream>())
+
+      .AddAttribute("Workers", "Number of jobs served in parallel, 0 for infinite capacity",
+                    UintegerValue(0),
+                    MakeUintegerAccessor(&KiteServiceQueue::m_workers), MakeUintegerChecker<uint32_t>())
+
+      .AddAttribute("QueueSize", "Maximum number of jobs waiting for a worker",
+                    UintegerValue(100),
+                    MakeUintegerAccessor(&KiteServiceQueue::m_queueSize), MakeUintegerChecker<uint32_t>())
+
+      .AddTraceSource("QueueDepth", "Number of jobs waiting for a worker",
+                      MakeTraceSourceAccessor(&KiteServiceQueue::m_queueDepth),
+                      "ns3::TracedValueCallback::Uint32")
+
+      .AddTraceSource("WaitingTime", "Time a job waited for a worker, reported when its service starts",
+                      MakeTraceSourceAccessor(&KiteServiceQueue::m_waitingTime),
+                      "ns3::ndn::KiteServiceQueue::WaitingTimeCallback")
+    ;
+
+  return tid;
+}
+
+KiteServiceQueue::KiteServiceQueue()
+  : m_workers(0)
+  , m_queueSize(100)
+  , m_busy(0)
+  , m_dropped(0)
+  , m_queueDepth(0)
+{
+}
+
+void
+KiteServiceQueue::DoDispose()
+{
+  m_queue.clear();
+  m_serviceTime = 0;
+
+  Object::DoDispose();
+}
+
+bool
+KiteServiceQueue::Enqueue(const std::function<void()>& job)
+{
+  if (m_workers == 0) {
+    job();
+    return true;
+  }
+
+  Job queued;
+  queued.run = job;
+  queued.arrival = Simulator::Now();
+
+  if (m_busy < m_workers) {
+    m_busy++;
+    StartService(queued);
+    return true;
+  }
+
+  if (m_queue.size() >= m_queueSize) {
+    NS_LOG_DEBUG("Queue full, dropping job (" << m_dropped + 1 << " dropped)");
+    m_dropped++;
+    return false;
+  }
+
+  m_queue.push_back(queued);
+  m_queueDepth = m_queue.size();
+  return true;
+}
+
+void
+KiteServiceQueue::StartService(const Job& job)
+{
+  m_waitingTime(Simulator::Now() - job.arrival);
+
+  Time serviceTime = Seconds(std::max(0.0, m_serviceTime->GetValue()));
+  Simulator::Schedule(serviceTime, &KiteServiceQueue::CompleteService, this, job);
+}
+
+void
+KiteServiceQueue::CompleteService(Job job)
+{
+  job.run();
+
+  if (m_queue.empty()) {
+    m_busy--;
+    return;
+  }
+
+  // the worker moves on to the oldest waiting job
+  Job next = m_queue.front();
+  m_queue.pop_front();
+  m_queueDepth = m_queue.size();
+  StartService(next);
+}
+
+} // namespace ndn
+} // namespace ns3
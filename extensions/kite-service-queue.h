@@ -0,0 +1,108 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NDN_KITE_SERVICE_QUEUE_H
+#define NDN_KITE_SERVICE_QUEUE_H
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/traced-callback.h"
+#include "ns3/traced-value.h"
+
+#include <deque>
+#include <functional>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-apps
+ * @brief Service model of a server application: Workers slots serving jobs for ServiceTime each,
+ * in front of a FIFO of at most QueueSize waiting jobs
+ *
+ * A job is run when its service ends.  Jobs arriving to a full queue are dropped.
+ * With Workers set to 0 (default) the server has infinite capacity and every job runs right away.
+ *
+ * Applications own one instance each and expose it through their ServiceQueue attribute, e.g.
+ * /NodeList/0/ApplicationList/0/$ns3::ndn::KiteUploadServer/ServiceQueue/WaitingTime.
+ */
+class KiteServiceQueue : public Object {
+public:
+  static TypeId
+  GetTypeId();
+
+  KiteServiceQueue();
+
+  /**
+   * @brief Queue a job
+   * @returns false if the queue is full and the job is dropped
+   */
+  bool
+  Enqueue(const std::function<void()>& job);
+
+  uint32_t
+  GetDepth() const
+  {
+    return m_queue.size();
+  }
+
+  uint32_t
+  GetDropped() const
+  {
+    return m_dropped;
+  }
+
+  typedef void (*WaitingTimeCallback)(Time waitingTime);
+
+protected:
+  virtual void
+  DoDispose();
+
+private:
+  struct Job
+  {
+    std::function<void()> run;
+    Time arrival;
+  };
+
+  void
+  StartService(const Job& job);
+
+  void
+  CompleteService(Job job);
+
+private:
+  Ptr<RandomVariableStream> m_serviceTime; ///< @brief in seconds
+  uint32_t m_workers;   ///< @brief 0 for infinite capacity
+  uint32_t m_queueSize;
+
+  std::deque<Job> m_queue;
+  uint32_t m_busy;
+  uint32_t m_dropped;
+
+  TracedValue<uint32_t> m_queueDepth;
+  TracedCallback<Time> m_waitingTime;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_KITE_SERVICE_QUEUE_H
@@ -0,0 +1,122 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "kite-shortcut-strategy.h"
+#include "kite-trace-refresh.h"
+
+#include "fw/algorithm.hpp"
+#include "core/logger.hpp"
+
+namespace nfd {
+namespace fw {
+
+NFD_LOG_INIT("KiteShortcutStrategy");
+
+const Name KiteShortcutStrategy::STRATEGY_NAME("ndn:/localhost/nfd/strategy/kite-shortcut/%FD%01");
+NFD_REGISTER_STRATEGY(KiteShortcutStrategy);
+
+KiteShortcutStrategy::KiteShortcutStrategy(Forwarder& forwarder, const Name& name)
+  : KiteTraceStrategy(forwarder, name)
+{
+}
+
+void
+KiteShortcutStrategy::afterReceiveInterest(const Face& inFace, const Interest& interest,
+                                           const shared_ptr<pit::Entry>& pitEntry)
+{
+  if (interest.getTraceFlag() == 1) {
+    learnTrace(inFace, interest);
+    sendToNextHop(inFace, interest, pitEntry);
+    return;
+  }
+
+  if (interest.getTraceFlag() == 2) {
+    Face* outFace = interest.hasTraceName() ? findTrace(interest.getTraceName()) : nullptr;
+    if (outFace != nullptr && outFace->getId() != inFace.getId()) {
+      NFD_LOG_INFO("Shortcut " << interest.getName() << " down trace "
+                   << interest.getTraceName() << " to face " << outFace->getId());
+      this->sendInterest(pitEntry, *outFace);
+    }
+    else {
+      // no trace known here: keep going up towards the anchor
+      sendToNextHop(inFace, interest, pitEntry);
+    }
+    return;
+  }
+
+  KiteTraceStrategy::afterReceiveInterest(inFace, interest, pitEntry);
+}
+
+void
+KiteShortcutStrategy::beforeSatisfyInterest(const shared_ptr<pit::Entry>& pitEntry,
+                                            const Face& inFace, const Data& data)
+{
+  ns3::ndn::KiteTraceRefresh refresh;
+  if (ns3::ndn::KiteTraceRefresh::extractFrom(data, refresh)) {
+    NFD_LOG_DEBUG("Refresh trace " << refresh.getTraceName() << " from face " << inFace.getId()
+                  << " for " << refresh.getLifetime());
+    m_traces.insert(refresh.getTraceName(), inFace.getId(),
+                    time::steady_clock::now() + refresh.getLifetime());
+  }
+
+  KiteTraceStrategy::beforeSatisfyInterest(pitEntry, inFace, data);
+}
+
+void
+KiteShortcutStrategy::learnTrace(const Face& inFace, const Interest& interest)
+{
+  m_traces.insert(interest.getName(), inFace.getId(),
+                  time::steady_clock::now() + interest.getInterestLifetime());
+}
+
+void
+KiteShortcutStrategy::sendToNextHop(const Face& inFace, const Interest& interest,
+                                    const shared_ptr<pit::Entry>& pitEntry)
+{
+  const fib::Entry& fibEntry = this->lookupFib(*pitEntry);
+  for (const fib::NextHop& nextHop : fibEntry.getNextHops()) {
+    Face& outFace = nextHop.getFace();
+    if (outFace.getId() != inFace.getId() && !wouldViolateScope(inFace, interest, outFace)) {
+      this->sendInterest(pitEntry, outFace);
+      return;
+    }
+  }
+
+  NFD_LOG_DEBUG("No nexthop for " << interest.getName() << " from face " << inFace.getId());
+  lp::NackHeader nackHeader;
+  nackHeader.setReason(lp::NackReason::NO_ROUTE);
+  this->sendNack(pitEntry, inFace, nackHeader);
+  this->rejectPendingInterest(pitEntry);
+}
+
+Face*
+KiteShortcutStrategy::findTrace(const Name& traceName)
+{
+  FaceId faceId = m_traces.find(traceName);
+  if (faceId == face::INVALID_FACEID)
+    return nullptr;
+
+  Face* traceFace = this->getFace(faceId);
+  if (traceFace == nullptr)
+    m_traces.erase(traceName);
+  return traceFace;
+}
+
+} // namespace fw
+} // namespace nfd
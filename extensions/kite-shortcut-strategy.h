@@ -0,0 +1,93 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NFD_KITE_SHORTCUT_STRATEGY_H
+#define NFD_KITE_SHORTCUT_STRATEGY_H
+
+#include "kite-trace-hash-table.h"
+
+#include "fw/kite-trace-strategy.hpp"
+
+namespace nfd {
+namespace fw {
+
+/**
+ * @brief Kite trace strategy that lets tracing Interests take a shortcut down a known trace
+ *
+ * Every traced Interest (TraceFlag 1) passing through the router is remembered together with
+ * the face it came in on, for as long as its lifetime.  A tracing Interest (TraceFlag 2) whose
+ * trace name matches one of these entries is sent down that face right away, instead of being
+ * forwarded up to the anchor first.
+ *
+ * Data carrying a KiteTraceRefresh marker refreshes the trace it names, with the face the Data
+ * came in on, so a mobile busy uploading does not need traced Interests to keep its trace alive.
+ *
+ * The strategy owns the trace state of the router: traced and tracing Interests are forwarded
+ * by the strategy itself along the FIB and never handed to KiteTraceStrategy, so no name-tree
+ * trace entry or per-entry expiry event is created for them.  Traces are kept in a KiteTraceHashTable,
+ * whose footprint stays small on routers crossed by the traces of many mobiles.  Plain Interests
+ * and Data are handled by KiteTraceStrategy.
+ */
+class KiteShortcutStrategy : public KiteTraceStrategy
+{
+public:
+  explicit
+  KiteShortcutStrategy(Forwarder& forwarder, const Name& name = STRATEGY_NAME);
+
+  void
+  afterReceiveInterest(const Face& inFace, const Interest& interest,
+                       const shared_ptr<pit::Entry>& pitEntry) override;
+
+  void
+  beforeSatisfyInterest(const shared_ptr<pit::Entry>& pitEntry,
+                        const Face& inFace, const Data& data) override;
+
+  const KiteTraceHashTable&
+  getShortcutTable() const
+  {
+    return m_traces;
+  }
+
+public:
+  static const Name STRATEGY_NAME;
+
+private:
+  void
+  learnTrace(const Face& inFace, const Interest& interest);
+
+  /**
+   * @brief Send the Interest to the first FIB nexthop other than inFace, or Nack it with NoRoute
+   */
+  void
+  sendToNextHop(const Face& inFace, const Interest& interest, const shared_ptr<pit::Entry>& pitEntry);
+
+  /**
+   * @return the face the trace for traceName comes from, nullptr if none is known
+   */
+  Face*
+  findTrace(const Name& traceName);
+
+private:
+  KiteTraceHashTable m_traces;
+};
+
+} // namespace fw
+} // namespace nfd
+
+#endif // NFD_KITE_SHORTCUT_STRATEGY_H
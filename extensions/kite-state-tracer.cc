@@ -0,0 +1,184 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "kite-state-tracer.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/node-list.h"
+#include "ns3/names.h"
+
+#include "model/ndn-l3-protocol.hpp"
+#include "fw/forwarder.hpp"
+
+#include "kite-shortcut-strategy.h"
+
+#include <boost/lexical_cast.hpp>
+
+#include <list>
+#include <tuple>
+
+NS_LOG_COMPONENT_DEFINE("ndn.kite.KiteStateTracer");
+
+namespace ns3 {
+namespace ndn {
+
+static std::list<std::tuple<shared_ptr<std::ostream>, std::list<Ptr<KiteStateTracer>>>> g_tracers;
+
+void
+KiteStateTracer::Destroy()
+{
+  g_tracers.clear();
+}
+
+void
+KiteStateTracer::InstallAll(const std::string& file, Time samplingPeriod)
+{
+  NodeContainer nodes;
+  for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
+    nodes.Add(*node);
+  }
+
+  Install(nodes, file, samplingPeriod);
+}
+
+void
+KiteStateTracer::Install(const NodeContainer& nodes, const std::string& file, Time samplingPeriod)
+{
+  std::list<Ptr<KiteStateTracer>> tracers;
+  shared_ptr<std::ostream> outputStream;
+  if (file != "-") {
+    shared_ptr<std::ofstream> os(new std::ofstream());
+    os->open(file.c_str(), std::ios_base::out | std::ios_base::trunc);
+
+    if (!os->is_open()) {
+      NS_LOG_ERROR("File " << file << " cannot be opened for writing. Tracing disabled");
+      return;
+    }
+
+    outputStream = os;
+  }
+  else {
+    outputStream = shared_ptr<std::ostream>(&std::cout, std::bind([]{}));
+  }
+
+  for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); node++) {
+    if ((*node)->GetObject<L3Protocol>() == 0)
+      continue;
+
+    Ptr<KiteStateTracer> trace = Create<KiteStateTracer>(outputStream, *node);
+    trace->SetSamplingPeriod(samplingPeriod);
+    tracers.push_back(trace);
+  }
+
+  if (tracers.size() > 0) {
+    tracers.front()->PrintHeader(*outputStream);
+    *outputStream << "\n";
+  }
+
+  if (g_tracers.empty()) {
+    Simulator::ScheduleDestroy(&KiteStateTracer::Destroy);
+  }
+  g_tracers.push_back(std::make_tuple(outputStream, tracers));
+}
+
+KiteStateTracer::KiteStateTracer(shared_ptr<std::ostream> os, Ptr<Node> node)
+  : m_os(os)
+  , m_nodePtr(node)
+{
+  m_node = boost::lexical_cast<std::string>(m_nodePtr->GetId());
+
+  std::string name = Names::FindName(node);
+  if (!name.empty()) {
+    m_node = name;
+  }
+}
+
+KiteStateTracer::~KiteStateTracer()
+{
+  m_printEvent.Cancel();
+}
+
+void
+KiteStateTracer::SetSamplingPeriod(const Time& period)
+{
+  m_period = period;
+  m_printEvent.Cancel();
+  if (m_period != Time(0)) {
+    m_printEvent = Simulator::Schedule(m_period, &KiteStateTracer::PeriodicPrinter, this);
+  }
+}
+
+void
+KiteStateTracer::PeriodicPrinter()
+{
+  Print(*m_os);
+  m_printEvent = Simulator::Schedule(m_period, &KiteStateTracer::PeriodicPrinter, this);
+}
+
+void
+KiteStateTracer::PrintHeader(std::ostream& os) const
+{
+  os << "Time"
+     << "\t"
+     << "Node"
+     << "\t"
+     << "PitEntries"
+     << "\t"
+     << "TraceEntries"
+     << "\t"
+     << "PitBytes"
+     << "\t"
+     << "ShortcutEntries"
+     << "\t"
+     << "ShortcutBytes";
+}
+
+void
+KiteStateTracer::Print(std::ostream& os) const
+{
+  shared_ptr<nfd::Forwarder> forwarder = m_nodePtr->GetObject<L3Protocol>()->getForwarder();
+
+  const nfd::Pit& pit = forwarder->getPit();
+  size_t pitBytes = 0;
+  for (const nfd::pit::Entry& entry : pit) {
+    pitBytes += sizeof(nfd::pit::Entry) + entry.getInterest().wireEncode().size()
+                + entry.getInRecords().size() * sizeof(nfd::pit::InRecord)
+                + entry.getOutRecords().size() * sizeof(nfd::pit::OutRecord);
+  }
+
+  // trace entries are kept by the Kite forwarder next to the PIT
+  size_t traceEntries = forwarder->getTraceTable().size();
+
+  os << Simulator::Now().ToDouble(Time::S) << "\t" << m_node << "\t"
+     << pit.size() << "\t" << traceEntries << "\t"
+     << pitBytes << "\t";
+
+  // traces learned by the shortcut strategy, not measured (NA) on nodes running another strategy
+  const nfd::fw::KiteShortcutStrategy* shortcut =
+    dynamic_cast<const nfd::fw::KiteShortcutStrategy*>(&forwarder->getStrategyChoice().findEffectiveStrategy("/"));
+  if (shortcut != nullptr) {
+    os << shortcut->getShortcutTable().size() << "\t" << shortcut->getShortcutTable().getMemoryUsage() << "\n";
+  }
+  else {
+    os << "NA" << "\t" << "NA" << "\n";
+  }
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,98 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NDN_KITE_STATE_TRACER_H
+#define NDN_KITE_STATE_TRACER_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/simple-ref-count.h"
+
+#include <fstream>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-tracers
+ * @brief Periodically samples router state kept for Kite on every node
+ *
+ * Instead of logging each PIT or trace table operation (which is unusable on long runs),
+ * the tracer writes one row per node and per period with the number of PIT entries and their memory,
+ * and the number of entries in the trace table of the forwarder.  The forwarder does not expose the size
+ * of a trace entry, so no trace bytes are written.  On nodes running KiteShortcutStrategy, the size and
+ * memory of its own trace table are written in separate columns, NA on the other nodes.
+ */
+class KiteStateTracer : public SimpleRefCount<KiteStateTracer> {
+public:
+  /**
+   * @brief Helper method to install tracers on all simulation nodes
+   *
+   * @param file File to which traces will be written.  If filename is -, then std::out is used
+   * @param samplingPeriod How often the state is sampled
+   */
+  static void
+  InstallAll(const std::string& file, Time samplingPeriod = Seconds(1.0));
+
+  /**
+   * @brief Helper method to install tracers on the selected simulation nodes
+   */
+  static void
+  Install(const NodeContainer& nodes, const std::string& file, Time samplingPeriod = Seconds(1.0));
+
+  /**
+   * @brief Explicit request to remove all statically created tracers
+   */
+  static void
+  Destroy();
+
+  KiteStateTracer(shared_ptr<std::ostream> os, Ptr<Node> node);
+
+  ~KiteStateTracer();
+
+  void
+  PrintHeader(std::ostream& os) const;
+
+  void
+  SetSamplingPeriod(const Time& period);
+
+private:
+  void
+  PeriodicPrinter();
+
+  void
+  Print(std::ostream& os) const;
+
+private:
+  shared_ptr<std::ostream> m_os;
+  Ptr<Node> m_nodePtr;
+  std::string m_node;
+
+  Time m_period;
+  EventId m_printEvent;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_KITE_STATE_TRACER_H
@@ -0,0 +1,147 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "kite-topology.h"
+
+#include "ns3/channel.h"
+#include "ns3/net-device.h"
+#include "ns3/mobility-model.h"
+#include "ns3/point-to-point-channel.h"
+#include "ns3/point-to-point-net-device.h"
+
+#include <algorithm>
+#include <map>
+#include <queue>
+
+namespace ns3 {
+namespace ndn {
+
+std::vector<Ptr<Node>>
+KiteTopology::GetNeighbors(Ptr<Node> node, double wirelessRange)
+{
+  std::vector<Ptr<Node>> neighbors;
+  Ptr<MobilityModel> position = node->GetObject<MobilityModel>();
+
+  for (uint32_t i = 0; i < node->GetNDevices(); i++) {
+    Ptr<Channel> channel = node->GetDevice(i)->GetChannel();
+    if (channel == 0)
+      continue;
+
+    bool wireless = DynamicCast<PointToPointChannel>(channel) == 0;
+    for (uint32_t j = 0; j < channel->GetNDevices(); j++) {
+      Ptr<Node> other = channel->GetDevice(j)->GetNode();
+      if (other == node || std::find(neighbors.begin(), neighbors.end(), other) != neighbors.end())
+        continue;
+
+      if (wireless) {
+        Ptr<MobilityModel> otherPosition = other->GetObject<MobilityModel>();
+        if (position != 0 && otherPosition != 0 && position->GetDistanceFrom(otherPosition) > wirelessRange)
+          continue;
+      }
+      neighbors.push_back(other);
+    }
+  }
+  return neighbors;
+}
+
+int
+KiteTopology::GetHopCount(Ptr<Node> from, Ptr<Node> to, double wirelessRange)
+{
+  if (from == to)
+    return 0;
+
+  std::map<uint32_t, int> distances;
+  std::queue<Ptr<Node>> queue;
+  distances[from->GetId()] = 0;
+  queue.push(from);
+
+  while (!queue.empty()) {
+    Ptr<Node> node = queue.front();
+    queue.pop();
+    int distance = distances[node->GetId()];
+
+    for (Ptr<Node> neighbor : GetNeighbors(node, wirelessRange)) {
+      if (distances.count(neighbor->GetId()) > 0)
+        continue;
+
+      if (neighbor == to)
+        return distance + 1;
+
+      distances[neighbor->GetId()] = distance + 1;
+      queue.push(neighbor);
+    }
+  }
+  return -1;
+}
+
+std::vector<Ptr<Node>>
+KiteTopology::GetShortestPath(Ptr<Node> from, Ptr<Node> to, double wirelessRange)
+{
+  std::map<uint32_t, Ptr<Node>> parents;
+  std::queue<Ptr<Node>> queue;
+  parents[from->GetId()] = from;
+  queue.push(from);
+
+  while (!queue.empty() && parents.count(to->GetId()) == 0) {
+    Ptr<Node> node = queue.front();
+    queue.pop();
+
+    for (Ptr<Node> neighbor : GetNeighbors(node, wirelessRange)) {
+      if (parents.count(neighbor->GetId()) > 0)
+        continue;
+
+      parents[neighbor->GetId()] = node;
+      queue.push(neighbor);
+    }
+  }
+
+  std::vector<Ptr<Node>> path;
+  if (parents.count(to->GetId()) == 0)
+    return path;
+
+  for (Ptr<Node> node = to; node != from; node = parents[node->GetId()]) {
+    path.push_back(node);
+  }
+  path.push_back(from);
+  std::reverse(path.begin(), path.end());
+  return path;
+}
+
+DataRate
+KiteTopology::GetLinkRate(Ptr<Node> from, Ptr<Node> to)
+{
+  for (uint32_t i = 0; i < from->GetNDevices(); i++) {
+    Ptr<PointToPointNetDevice> device = DynamicCast<PointToPointNetDevice>(from->GetDevice(i));
+    if (device == 0 || device->GetChannel() == 0)
+      continue;
+
+    Ptr<Channel> channel = device->GetChannel();
+    for (uint32_t j = 0; j < channel->GetNDevices(); j++) {
+      if (channel->GetDevice(j)->GetNode() == to) {
+        DataRateValue rate;
+        device->GetAttribute("DataRate", rate);
+        return rate.Get();
+      }
+    }
+  }
+  return DataRate(0);
+}
+
+} // namespace ndn
+} // namespace ns3
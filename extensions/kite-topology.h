@@ -0,0 +1,66 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NDN_KITE_TOPOLOGY_H
+#define NDN_KITE_TOPOLOGY_H
+
+#include "ns3/node.h"
+#include "ns3/ptr.h"
+#include "ns3/data-rate.h"
+
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Shortest paths over the current topology of the simulation
+ *
+ * Nodes are adjacent when they share a point-to-point channel, or a shared medium channel (wifi)
+ * and are within wirelessRange meters of each other.  Nodes without a mobility model are taken
+ * to be in range of everything on their shared channels.
+ */
+class KiteTopology {
+public:
+  static std::vector<Ptr<Node>>
+  GetNeighbors(Ptr<Node> node, double wirelessRange);
+
+  /**
+   * @brief Number of links on the shortest path between two nodes, -1 if there is none
+   */
+  static int
+  GetHopCount(Ptr<Node> from, Ptr<Node> to, double wirelessRange);
+
+  /**
+   * @brief Nodes on a shortest path from one node to another, both included, empty if there is none
+   */
+  static std::vector<Ptr<Node>>
+  GetShortestPath(Ptr<Node> from, Ptr<Node> to, double wirelessRange);
+
+  /**
+   * @brief Data rate of the point-to-point link from one node to another, 0 if they share none
+   */
+  static DataRate
+  GetLinkRate(Ptr<Node> from, Ptr<Node> to);
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_KITE_TOPOLOGY_H
@@ -0,0 +1,246 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "kite-trace-hash-table.h"
+
+namespace nfd {
+namespace fw {
+
+static const size_t INITIAL_CAPACITY = 16;
+
+KiteTraceHashTable::KiteTraceHashTable(time::milliseconds tick)
+  : m_tick(tick)
+  , m_slots(INITIAL_CAPACITY)
+  , m_size(0)
+{
+  m_now = toTick(time::steady_clock::now());
+}
+
+void
+KiteTraceHashTable::insert(const Name& traceName, FaceId face,
+                           const time::steady_clock::TimePoint& expiry)
+{
+  advance();
+
+  if ((m_size + 1) * 4 > m_slots.size() * 3) {
+    grow();
+  }
+
+  uint64_t key = computeKey(traceName);
+  // round up, a trace may live one tick longer but never shorter than asked
+  uint32_t tick = toTick(expiry) + 1;
+
+  Slot& slot = m_slots[probe(key)];
+  if (slot.key == key) {
+    // the pending timer of the slot reschedules itself if the new expiry is later
+    slot.face = face;
+    slot.expiry = tick;
+    return;
+  }
+
+  slot.key = key;
+  slot.face = face;
+  slot.expiry = tick;
+  ++m_size;
+  schedule(key, tick);
+}
+
+FaceId
+KiteTraceHashTable::find(const Name& traceName)
+{
+  advance();
+
+  const Slot& slot = m_slots[probe(computeKey(traceName))];
+  if (slot.key == 0 || slot.expiry <= m_now)
+    return face::INVALID_FACEID;
+
+  return slot.face;
+}
+
+void
+KiteTraceHashTable::erase(const Name& traceName)
+{
+  advance();
+
+  Slot& slot = m_slots[probe(computeKey(traceName))];
+  if (slot.key != 0)
+    slot.expiry = m_now;
+}
+
+size_t
+KiteTraceHashTable::getMemoryUsage() const
+{
+  size_t bytes = m_slots.capacity() * sizeof(Slot);
+  for (size_t level = 0; level < WHEEL_LEVELS; level++) {
+    for (size_t bucket = 0; bucket < WHEEL_SIZE; bucket++) {
+      bytes += m_wheel[level][bucket].capacity() * sizeof(Timer);
+    }
+  }
+  return bytes;
+}
+
+uint64_t
+KiteTraceHashTable::computeKey(const Name& name)
+{
+  // FNV-1a over the wire encoding
+  const Block& block = name.wireEncode();
+  uint64_t hash = 14695981039346656037ULL;
+  for (Block::const_iterator it = block.begin(); it != block.end(); ++it) {
+    hash ^= static_cast<uint8_t>(*it);
+    hash *= 1099511628211ULL;
+  }
+
+  // finalizer of MurmurHash3, so that both halves depend on every byte
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+
+  return hash == 0 ? 1 : hash;
+}
+
+uint32_t
+KiteTraceHashTable::toTick(const time::steady_clock::TimePoint& timePoint) const
+{
+  return static_cast<uint32_t>(
+    time::duration_cast<time::milliseconds>(timePoint.time_since_epoch()).count() / m_tick.count());
+}
+
+size_t
+KiteTraceHashTable::probe(uint64_t key) const
+{
+  size_t mask = m_slots.size() - 1;
+  size_t index = getHome(key);
+  while (m_slots[index].key != 0 && m_slots[index].key != key) {
+    index = (index + 1) & mask;
+  }
+  return index;
+}
+
+void
+KiteTraceHashTable::removeSlot(size_t index)
+{
+  // backward shift deletion: pull later entries of the probe sequence into the hole
+  size_t mask = m_slots.size() - 1;
+  size_t hole = index;
+  for (size_t next = (index + 1) & mask; m_slots[next].key != 0; next = (next + 1) & mask) {
+    size_t home = getHome(m_slots[next].key);
+    if (((next - home) & mask) >= ((next - hole) & mask)) {
+      m_slots[hole] = m_slots[next];
+      hole = next;
+    }
+  }
+
+  m_slots[hole].key = 0;
+  --m_size;
+}
+
+void
+KiteTraceHashTable::grow()
+{
+  std::vector<Slot> slots(m_slots.size() * 2);
+  slots.swap(m_slots);
+
+  for (const Slot& slot : slots) {
+    if (slot.key != 0)
+      m_slots[probe(slot.key)] = slot;
+  }
+}
+
+void
+KiteTraceHashTable::schedule(uint64_t key, uint32_t tick)
+{
+  static const uint32_t MAX_DELTA = (1 << (WHEEL_BITS * WHEEL_LEVELS)) - 1;
+
+  if (tick <= m_now) {
+    tick = m_now + 1;
+  }
+  // beyond the range of the wheel the timer fires early and reschedules itself
+  if (tick - m_now > MAX_DELTA) {
+    tick = m_now + MAX_DELTA;
+  }
+
+  uint32_t delta = tick - m_now;
+  size_t level = 0;
+  while (delta >> (WHEEL_BITS * (level + 1)) != 0) {
+    level++;
+  }
+
+  size_t bucket = (tick >> (WHEEL_BITS * level)) & (WHEEL_SIZE - 1);
+  m_wheel[level][bucket].push_back(Timer{key, tick});
+}
+
+void
+KiteTraceHashTable::advance()
+{
+  uint32_t target = toTick(time::steady_clock::now());
+
+  std::vector<Timer> due;
+  while (m_now < target) {
+    if (m_size == 0) {
+      // every entry owns exactly one timer, so the wheel is empty as well
+      m_now = target;
+      break;
+    }
+
+    ++m_now;
+
+    // on a wrap of a lower level, spread the next bucket of the level above over the levels below
+    for (size_t level = WHEEL_LEVELS - 1; level > 0; level--) {
+      if ((m_now & ((1 << (WHEEL_BITS * level)) - 1)) != 0)
+        continue;
+
+      size_t bucket = (m_now >> (WHEEL_BITS * level)) & (WHEEL_SIZE - 1);
+      due.swap(m_wheel[level][bucket]);
+      for (const Timer& timer : due) {
+        schedule(timer.key, timer.tick);
+      }
+      due.clear();
+    }
+
+    std::vector<Timer>& bucket = m_wheel[0][m_now & (WHEEL_SIZE - 1)];
+    due.swap(bucket);
+    for (const Timer& timer : due) {
+      fire(timer);
+    }
+    due.clear();
+    if (bucket.empty()) {
+      bucket.swap(due);
+    }
+  }
+}
+
+void
+KiteTraceHashTable::fire(const Timer& timer)
+{
+  size_t index = probe(timer.key);
+  if (m_slots[index].key == 0)
+    return;
+
+  if (m_slots[index].expiry > timer.tick) {
+    schedule(timer.key, m_slots[index].expiry);
+  }
+  else {
+    removeSlot(index);
+  }
+}
+
+} // namespace fw
+} // namespace nfd
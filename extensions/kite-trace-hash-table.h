@@ -0,0 +1,151 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NFD_KITE_TRACE_HASH_TABLE_H
+#define NFD_KITE_TRACE_HASH_TABLE_H
+
+#include "face/face.hpp"
+
+#include <ndn-cxx/name.hpp>
+#include <ndn-cxx/util/time.hpp>
+
+#include <vector>
+
+namespace nfd {
+namespace fw {
+
+/**
+ * @brief Compact table of traces, mapping a trace name to the face the trace comes from
+ *
+ * Entries are kept in an open-addressing table with linear probing.  A trace name is reduced to a
+ * 64-bit key of its wire encoding: the upper half picks the home slot and the whole key is compared
+ * on lookup, so two names only share an entry if all 64 bits collide; names themselves are not stored.  Expiry is handled by a three-level hierarchical timer wheel
+ * that is advanced on every access, so the table never schedules simulator events and each
+ * stored entry costs one slot and one timer.
+ */
+class KiteTraceHashTable
+{
+public:
+  explicit
+  KiteTraceHashTable(time::milliseconds tick = time::milliseconds(10));
+
+  /**
+   * @brief Insert or refresh the trace for traceName
+   */
+  void
+  insert(const Name& traceName, FaceId face, const time::steady_clock::TimePoint& expiry);
+
+  /**
+   * @return the face of the unexpired trace for traceName, face::INVALID_FACEID if there is none
+   */
+  FaceId
+  find(const Name& traceName);
+
+  /**
+   * @brief Make the trace for traceName expire; the slot is reclaimed by its timer
+   */
+  void
+  erase(const Name& traceName);
+
+  /**
+   * @brief Number of stored entries, including expired ones not yet reclaimed
+   */
+  size_t
+  size() const
+  {
+    return m_size;
+  }
+
+  /**
+   * @brief Bytes allocated for slots and timers
+   */
+  size_t
+  getMemoryUsage() const;
+
+private:
+  struct Slot
+  {
+    uint64_t key;    ///< 0 marks an empty slot
+    uint32_t expiry; ///< in ticks
+    FaceId face;
+  };
+
+  struct Timer
+  {
+    uint64_t key;
+    uint32_t tick;
+  };
+
+  static uint64_t
+  computeKey(const Name& name);
+
+  /**
+   * @return home slot of key, from the bits of the key not taken by the low half
+   */
+  size_t
+  getHome(uint64_t key) const
+  {
+    return static_cast<size_t>(key >> 32) & (m_slots.size() - 1);
+  }
+
+  uint32_t
+  toTick(const time::steady_clock::TimePoint& timePoint) const;
+
+  /**
+   * @return index of the slot holding key, or of the empty slot ending its probe sequence
+   */
+  size_t
+  probe(uint64_t key) const;
+
+  void
+  removeSlot(size_t index);
+
+  void
+  grow();
+
+  void
+  schedule(uint64_t key, uint32_t tick);
+
+  /**
+   * @brief Advance the wheel to the current time, reclaiming expired slots
+   */
+  void
+  advance();
+
+  void
+  fire(const Timer& timer);
+
+private:
+  static const size_t WHEEL_BITS = 6;
+  static const size_t WHEEL_SIZE = 1 << WHEEL_BITS;
+  static const size_t WHEEL_LEVELS = 3;
+
+  time::milliseconds m_tick;
+
+  std::vector<Slot> m_slots;
+  size_t m_size;
+
+  std::vector<Timer> m_wheel[WHEEL_LEVELS][WHEEL_SIZE];
+  uint32_t m_now; ///< last tick the wheel has been advanced to
+};
+
+} // namespace fw
+} // namespace nfd
+
+#endif // NFD_KITE_TRACE_HASH_TABLE_H
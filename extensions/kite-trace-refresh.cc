@@ -0,0 +1,103 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "kite-trace-refresh.h"
+
+#include <ndn-cxx/encoding/block-helpers.hpp>
+#include <ndn-cxx/encoding/encoding-buffer.hpp>
+
+namespace ns3 {
+namespace ndn {
+
+KiteTraceRefresh::KiteTraceRefresh()
+  : m_lifetime(0)
+{
+}
+
+KiteTraceRefresh::KiteTraceRefresh(const Name& traceName, time::milliseconds lifetime)
+  : m_traceName(traceName)
+  , m_lifetime(lifetime)
+{
+}
+
+KiteTraceRefresh::KiteTraceRefresh(const Block& block)
+  : m_lifetime(0)
+{
+  wireDecode(block);
+}
+
+Block
+KiteTraceRefresh::wireEncode() const
+{
+  ::ndn::EncodingBuffer encoder;
+
+  size_t totalLength = 0;
+  totalLength += ::ndn::prependNonNegativeIntegerBlock(encoder, TLV_TRACE_LIFETIME, m_lifetime.count());
+  totalLength += m_traceName.wireEncode(encoder);
+
+  totalLength += encoder.prependVarNumber(totalLength);
+  totalLength += encoder.prependVarNumber(TLV_KITE_TRACE_REFRESH);
+
+  return encoder.block();
+}
+
+void
+KiteTraceRefresh::wireDecode(const Block& block)
+{
+  if (block.type() != TLV_KITE_TRACE_REFRESH) {
+    BOOST_THROW_EXCEPTION(::ndn::tlv::Error("Expecting KiteTraceRefresh block"));
+  }
+
+  block.parse();
+
+  for (const Block& element : block.elements()) {
+    switch (element.type()) {
+    case ::ndn::tlv::Name:
+      m_traceName.wireDecode(element);
+      break;
+    case TLV_TRACE_LIFETIME:
+      m_lifetime = time::milliseconds(::ndn::readNonNegativeInteger(element));
+      break;
+    default:
+      break;
+    }
+  }
+}
+
+void
+KiteTraceRefresh::attachTo(Data& data) const
+{
+  ::ndn::MetaInfo metaInfo = data.getMetaInfo();
+  metaInfo.addAppMetaInfo(wireEncode());
+  data.setMetaInfo(metaInfo);
+}
+
+bool
+KiteTraceRefresh::extractFrom(const Data& data, KiteTraceRefresh& refresh)
+{
+  const Block* block = data.getMetaInfo().findAppMetaInfo(TLV_KITE_TRACE_REFRESH);
+  if (block == nullptr)
+    return false;
+
+  refresh.wireDecode(*block);
+  return true;
+}
+
+} // namespace ndn
+} // namespace ns3
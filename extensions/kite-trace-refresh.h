@@ -0,0 +1,95 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NDN_KITE_TRACE_REFRESH_H
+#define NDN_KITE_TRACE_REFRESH_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-apps
+ * @brief Trace refresh marker piggybacked on Data sent by a mobile
+ *
+ * A mobile that is busy answering tracing Interests can keep its trace alive without sending
+ * traced Interests: each Data it sends carries the marker in its MetaInfo, as an AppMetaInfo element
+ *
+ *     KiteTraceRefresh ::= KITE-TRACE-REFRESH-TYPE TLV-LENGTH
+ *                            Name
+ *                            TraceLifetime
+ *
+ * where Name is the name of the traced Interest that set up the trace and TraceLifetime, in milliseconds,
+ * replaces the remaining lifetime of the trace on every router forwarding the Data.
+ */
+class KiteTraceRefresh {
+public:
+  enum {
+    TLV_KITE_TRACE_REFRESH = 210,
+    TLV_TRACE_LIFETIME = 211
+  };
+
+  KiteTraceRefresh();
+
+  KiteTraceRefresh(const Name& traceName, time::milliseconds lifetime);
+
+  explicit
+  KiteTraceRefresh(const Block& block);
+
+  Block
+  wireEncode() const;
+
+  void
+  wireDecode(const Block& block);
+
+  const Name&
+  getTraceName() const
+  {
+    return m_traceName;
+  }
+
+  time::milliseconds
+  getLifetime() const
+  {
+    return m_lifetime;
+  }
+
+  /**
+   * @brief Add the marker to the MetaInfo of data, before it is encoded
+   */
+  void
+  attachTo(Data& data) const;
+
+  /**
+   * @brief Read the marker carried by data
+   * @return false if data carries none
+   */
+  static bool
+  extractFrom(const Data& data, KiteTraceRefresh& refresh);
+
+private:
+  Name m_traceName;
+  time::milliseconds m_lifetime;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_KITE_TRACE_REFRESH_H
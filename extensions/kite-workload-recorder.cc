@@ -0,0 +1,242 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "kite-workload-recorder.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/node-list.h"
+#include "ns3/config.h"
+#include "ns3/callback.h"
+
+#include "ns3/ndnSIM/apps/ndn-app.hpp"
+
+#include <cstring>
+#include <list>
+#include <tuple>
+#include <vector>
+
+NS_LOG_COMPONENT_DEFINE("ndn.kite.KiteWorkloadRecorder");
+
+namespace ns3 {
+namespace ndn {
+
+const char KiteWorkloadRecorder::MAGIC[8] = {'K', 'I', 'T', 'E', 'W', 'L', '0', '1'};
+
+static std::list<std::tuple<shared_ptr<std::ostream>, std::list<Ptr<KiteWorkloadRecorder>>>> g_recorders;
+
+KiteWorkloadRecorder::Record::Record()
+  : node(0)
+  , type(SENT_INTEREST)
+  , traceFlag(0)
+  , size(0)
+{
+}
+
+void
+KiteWorkloadRecorder::Destroy()
+{
+  for (const auto& recorders : g_recorders) {
+    std::get<0>(recorders)->flush();
+  }
+  g_recorders.clear();
+}
+
+void
+KiteWorkloadRecorder::InstallAll(const std::string& file)
+{
+  NodeContainer nodes;
+  for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
+    nodes.Add(*node);
+  }
+
+  Install(nodes, file);
+}
+
+void
+KiteWorkloadRecorder::Install(const NodeContainer& nodes, const std::string& file)
+{
+  shared_ptr<std::ofstream> os(new std::ofstream());
+  os->open(file.c_str(), std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+
+  if (!os->is_open()) {
+    NS_LOG_ERROR("File " << file << " cannot be opened for writing. Recording disabled");
+    return;
+  }
+  WriteHeader(*os);
+
+  std::list<Ptr<KiteWorkloadRecorder>> recorders;
+  for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); node++) {
+    Ptr<KiteWorkloadRecorder> recorder = Create<KiteWorkloadRecorder>(os, *node);
+    recorders.push_back(recorder);
+  }
+
+  if (g_recorders.empty()) {
+    Simulator::ScheduleDestroy(&KiteWorkloadRecorder::Destroy);
+  }
+  g_recorders.push_back(std::make_tuple(os, recorders));
+}
+
+KiteWorkloadRecorder::KiteWorkloadRecorder(shared_ptr<std::ostream> os, Ptr<Node> node)
+  : m_os(os)
+  , m_nodePtr(node)
+{
+  std::string path = "/NodeList/" + std::to_string(node->GetId()) + "/ApplicationList/*/$ns3::ndn::App/";
+  Config::ConnectWithoutContext(path + "TransmittedInterests",
+                                MakeCallback(&KiteWorkloadRecorder::SentInterest, this));
+  Config::ConnectWithoutContext(path + "ReceivedInterests",
+                                MakeCallback(&KiteWorkloadRecorder::ReceivedInterest, this));
+  Config::ConnectWithoutContext(path + "TransmittedDatas",
+                                MakeCallback(&KiteWorkloadRecorder::SentData, this));
+}
+
+void
+KiteWorkloadRecorder::SentInterest(shared_ptr<const Interest> interest, Ptr<App>, shared_ptr<Face>)
+{
+  RecordInterest(*interest, SENT_INTEREST);
+}
+
+void
+KiteWorkloadRecorder::ReceivedInterest(shared_ptr<const Interest> interest, Ptr<App>, shared_ptr<Face>)
+{
+  RecordInterest(*interest, RECEIVED_INTEREST);
+}
+
+void
+KiteWorkloadRecorder::RecordInterest(const Interest& interest, uint8_t type)
+{
+  Record record;
+  record.time = Simulator::Now();
+  record.node = m_nodePtr->GetId();
+  record.type = type;
+  record.traceFlag = interest.getTraceFlag();
+  record.lifetime = MilliSeconds(interest.getInterestLifetime().count());
+  record.name = interest.getName();
+  if (interest.hasTraceName()) {
+    record.traceName = interest.getTraceName();
+  }
+
+  WriteRecord(*m_os, record);
+}
+
+void
+KiteWorkloadRecorder::SentData(shared_ptr<const Data> data, Ptr<App>, shared_ptr<Face>)
+{
+  Record record;
+  record.time = Simulator::Now();
+  record.node = m_nodePtr->GetId();
+  record.type = SENT_DATA;
+  record.size = data->getContent().value_size();
+  record.name = data->getName();
+
+  WriteRecord(*m_os, record);
+}
+
+void
+KiteWorkloadRecorder::WriteHeader(std::ostream& os)
+{
+  os.write(MAGIC, sizeof(MAGIC));
+}
+
+bool
+KiteWorkloadRecorder::ReadHeader(std::istream& is)
+{
+  char magic[sizeof(MAGIC)];
+  if (!is.read(magic, sizeof(magic)))
+    return false;
+
+  return std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+template<class T>
+static void
+WriteValue(std::ostream& os, T value)
+{
+  os.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template<class T>
+static bool
+ReadValue(std::istream& is, T& value)
+{
+  return static_cast<bool>(is.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+static void
+WriteName(std::ostream& os, const Name& name)
+{
+  if (name.empty()) {
+    WriteValue<uint16_t>(os, 0);
+    return;
+  }
+
+  const Block& wire = name.wireEncode();
+  WriteValue<uint16_t>(os, wire.size());
+  os.write(reinterpret_cast<const char*>(wire.wire()), wire.size());
+}
+
+static bool
+ReadName(std::istream& is, Name& name)
+{
+  uint16_t length = 0;
+  if (!ReadValue(is, length))
+    return false;
+
+  if (length == 0) {
+    name = Name();
+    return true;
+  }
+
+  std::vector<uint8_t> buffer(length);
+  if (!is.read(reinterpret_cast<char*>(buffer.data()), length))
+    return false;
+
+  name = Name(Block(buffer.data(), buffer.size()));
+  return true;
+}
+
+void
+KiteWorkloadRecorder::WriteRecord(std::ostream& os, const Record& record)
+{
+  WriteValue<int64_t>(os, record.time.GetNanoSeconds());
+  WriteValue<uint32_t>(os, record.node);
+  WriteValue<uint8_t>(os, record.type);
+  WriteValue<uint8_t>(os, record.traceFlag);
+  WriteValue<uint32_t>(os, record.lifetime.GetMilliSeconds());
+  WriteValue<uint32_t>(os, record.size);
+  WriteName(os, record.name);
+  WriteName(os, record.traceName);
+}
+
+bool
+KiteWorkloadRecorder::ReadRecord(std::istream& is, Record& record)
+{
+  int64_t time = 0;
+  uint32_t lifetime = 0;
+  if (!ReadValue(is, time) || !ReadValue(is, record.node) || !ReadValue(is, record.type)
+      || !ReadValue(is, record.traceFlag) || !ReadValue(is, lifetime) || !ReadValue(is, record.size)
+      || !ReadName(is, record.name) || !ReadName(is, record.traceName))
+    return false;
+
+  record.time = NanoSeconds(time);
+  record.lifetime = MilliSeconds(lifetime);
+  return true;
+}
+
+} // namespace ndn
+} // namespace ns3
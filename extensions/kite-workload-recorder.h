@@ -0,0 +1,138 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NDN_KITE_WORKLOAD_RECORDER_H
+#define NDN_KITE_WORKLOAD_RECORDER_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/simple-ref-count.h"
+
+#include <fstream>
+
+namespace ns3 {
+namespace ndn {
+
+class App;
+
+/**
+ * @ingroup ndn-tracers
+ * @brief Records the packets exchanged at the application faces of a run, to replay them with KiteWorkloadReplay
+ *
+ * Every Interest and Data sent by an application and every Interest received by one is written
+ * as one binary record: time, node, type, TraceFlag, lifetime, content size, name and trace name.
+ * Names are stored in their TLV wire encoding, integers in host byte order,
+ * so a log is meant to be replayed on the machine that recorded it.
+ *
+ * Recorders hook into the applications present on the nodes, so they are installed after the applications.
+ */
+class KiteWorkloadRecorder : public SimpleRefCount<KiteWorkloadRecorder> {
+public:
+  enum RecordType {
+    SENT_INTEREST = 0,
+    SENT_DATA = 1,
+    RECEIVED_INTEREST = 2
+  };
+
+  /**
+   * @brief One packet at an application face
+   */
+  struct Record
+  {
+    Record();
+
+    Time time;
+    uint32_t node;
+    uint8_t type;      ///< @brief see RecordType
+    uint8_t traceFlag;
+    Time lifetime;     ///< @brief Interest lifetime, zero for Data
+    uint32_t size;     ///< @brief content size of Data, zero for Interests
+    Name name;
+    Name traceName;    ///< @brief empty if the Interest carries no trace name
+  };
+
+  /**
+   * @brief Helper method to install recorders on all simulation nodes
+   *
+   * @param file File to which the records will be written
+   */
+  static void
+  InstallAll(const std::string& file);
+
+  /**
+   * @brief Helper method to install recorders on the selected simulation nodes
+   */
+  static void
+  Install(const NodeContainer& nodes, const std::string& file);
+
+  /**
+   * @brief Explicit request to remove all statically created recorders
+   */
+  static void
+  Destroy();
+
+  /**
+   * @brief Check the header of a workload log
+   * @returns false if the stream does not hold a workload log
+   */
+  static bool
+  ReadHeader(std::istream& is);
+
+  /**
+   * @brief Read the next record of a workload log
+   * @returns false at the end of the log
+   */
+  static bool
+  ReadRecord(std::istream& is, Record& record);
+
+  static void
+  WriteHeader(std::ostream& os);
+
+  static void
+  WriteRecord(std::ostream& os, const Record& record);
+
+  KiteWorkloadRecorder(shared_ptr<std::ostream> os, Ptr<Node> node);
+
+private:
+  void
+  SentInterest(shared_ptr<const Interest> interest, Ptr<App> app, shared_ptr<Face> face);
+
+  void
+  ReceivedInterest(shared_ptr<const Interest> interest, Ptr<App> app, shared_ptr<Face> face);
+
+  void
+  SentData(shared_ptr<const Data> data, Ptr<App> app, shared_ptr<Face> face);
+
+  void
+  RecordInterest(const Interest& interest, uint8_t type);
+
+private:
+  static const char MAGIC[8];
+
+  shared_ptr<std::ostream> m_os;
+  Ptr<Node> m_nodePtr;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_KITE_WORKLOAD_RECORDER_H
@@ -0,0 +1,231 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "kite-workload-replay.h"
+
+#include "ns3/log.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+
+#include "helper/ndn-fib-helper.hpp"
+
+#include <algorithm>
+#include <fstream>
+
+NS_LOG_COMPONENT_DEFINE("ndn.kite.KiteWorkloadReplay");
+
+namespace ns3 {
+namespace ndn {
+
+NS_OBJECT_ENSURE_REGISTERED(KiteWorkloadReplay);
+
+TypeId
+KiteWorkloadReplay::GetTypeId(void)
+{
+  static TypeId tid =
+    TypeId("ns3::ndn::KiteWorkloadReplay")
+      .SetGroupName("Ndn")
+      .SetParent<App>()
+      .AddConstructor<KiteWorkloadReplay>()
+
+      .AddAttribute("File", "Workload log written by KiteWorkloadRecorder", StringValue("workload.bin"),
+                    MakeStringAccessor(&KiteWorkloadReplay::m_file), MakeStringChecker())
+      .AddAttribute("SourceNode", "Id of the recorded node whose workload is replayed", UintegerValue(0),
+                    MakeUintegerAccessor(&KiteWorkloadReplay::m_sourceNode), MakeUintegerChecker<uint32_t>())
+    ;
+  return tid;
+}
+
+KiteWorkloadReplay::KiteWorkloadReplay()
+  : m_sourceNode(0)
+  , m_rand(CreateObject<UniformRandomVariable>())
+  , m_next(0)
+{
+  NS_LOG_FUNCTION_NOARGS();
+}
+
+std::set<uint32_t>
+KiteWorkloadReplay::GetNodes(const std::string& file)
+{
+  std::set<uint32_t> nodes;
+
+  std::ifstream is(file.c_str(), std::ios_base::in | std::ios_base::binary);
+  if (!KiteWorkloadRecorder::ReadHeader(is)) {
+    NS_LOG_ERROR("File " << file << " is not a workload log");
+    return nodes;
+  }
+
+  KiteWorkloadRecorder::Record record;
+  while (KiteWorkloadRecorder::ReadRecord(is, record)) {
+    nodes.insert(record.node);
+  }
+  return nodes;
+}
+
+std::set<Name>
+KiteWorkloadReplay::GetServedPrefixes(const std::string& file, uint32_t node)
+{
+  std::set<Name> prefixes;
+
+  std::ifstream is(file.c_str(), std::ios_base::in | std::ios_base::binary);
+  if (!KiteWorkloadRecorder::ReadHeader(is)) {
+    NS_LOG_ERROR("File " << file << " is not a workload log");
+    return prefixes;
+  }
+
+  KiteWorkloadRecorder::Record record;
+  while (KiteWorkloadRecorder::ReadRecord(is, record)) {
+    if (record.node == node && record.type == KiteWorkloadRecorder::RECEIVED_INTEREST && !record.name.empty()) {
+      prefixes.insert(record.name.getPrefix(1));
+    }
+  }
+  return prefixes;
+}
+
+void
+KiteWorkloadReplay::StartApplication()
+{
+  NS_LOG_FUNCTION_NOARGS();
+  App::StartApplication();
+
+  std::ifstream is(m_file.c_str(), std::ios_base::in | std::ios_base::binary);
+  if (!KiteWorkloadRecorder::ReadHeader(is)) {
+    NS_LOG_ERROR("File " << m_file << " is not a workload log, nothing to replay");
+    return;
+  }
+
+  std::set<Name> prefixes;
+  KiteWorkloadRecorder::Record record;
+  while (KiteWorkloadRecorder::ReadRecord(is, record)) {
+    if (record.node != m_sourceNode)
+      continue;
+
+    switch (record.type) {
+    case KiteWorkloadRecorder::SENT_INTEREST:
+      m_interests.push_back(record);
+      break;
+    case KiteWorkloadRecorder::SENT_DATA:
+      m_datas[record.name] = record.size;
+      break;
+    case KiteWorkloadRecorder::RECEIVED_INTEREST:
+      if (!record.name.empty()) {
+        prefixes.insert(record.name.getPrefix(1));
+      }
+      break;
+    }
+  }
+
+  for (const Name& prefix : prefixes) {
+    FibHelper::AddRoute(GetNode(), prefix, m_face, 0);
+  }
+
+  // records of several applications on the node are interleaved, but each of them is in time order
+  std::stable_sort(m_interests.begin(), m_interests.end(),
+                   [] (const KiteWorkloadRecorder::Record& a, const KiteWorkloadRecorder::Record& b) {
+                     return a.time < b.time;
+                   });
+
+  NS_LOG_INFO("node(" << GetNode()->GetId() << ") replays " << m_interests.size() << " Interests and "
+              << m_datas.size() << " Data of node " << m_sourceNode);
+
+  m_next = 0;
+  if (!m_interests.empty()) {
+    Time delay = std::max(m_interests.front().time - Simulator::Now(), Time(0));
+    m_sendEvent = Simulator::Schedule(delay, &KiteWorkloadReplay::SendNext, this);
+  }
+}
+
+void
+KiteWorkloadReplay::StopApplication()
+{
+  NS_LOG_FUNCTION_NOARGS();
+
+  Simulator::Cancel(m_sendEvent);
+
+  App::StopApplication();
+}
+
+void
+KiteWorkloadReplay::SendNext()
+{
+  if (!m_active)
+    return;
+
+  // send everything recorded at this very time, then wait for the next record
+  while (m_next < m_interests.size() && m_interests[m_next].time <= Simulator::Now()) {
+    const KiteWorkloadRecorder::Record& record = m_interests[m_next++];
+
+    shared_ptr<Interest> interest = make_shared<Interest>();
+    interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+    interest->setName(record.name);
+    if (!record.traceName.empty()) {
+      interest->setTraceName(record.traceName);
+    }
+    if (record.traceFlag) {
+      interest->setTraceFlag(record.traceFlag);
+    }
+    time::milliseconds interestLifeTime(record.lifetime.GetMilliSeconds());
+    interest->setInterestLifetime(interestLifeTime);
+
+    NS_LOG_DEBUG("> Replayed Interest: " << interest->getName());
+
+    m_transmittedInterests(interest, this, m_face);
+    m_appLink->onReceiveInterest(*interest);
+  }
+
+  if (m_next < m_interests.size()) {
+    m_sendEvent = Simulator::Schedule(m_interests[m_next].time - Simulator::Now(), &KiteWorkloadReplay::SendNext, this);
+  }
+}
+
+void
+KiteWorkloadReplay::OnInterest(shared_ptr<const Interest> interest)
+{
+  App::OnInterest(interest); // tracing inside
+
+  if (!m_active)
+    return;
+
+  auto recorded = m_datas.find(interest->getName());
+  if (recorded == m_datas.end()) {
+    NS_LOG_DEBUG("No recorded Data for " << interest->getName());
+    return;
+  }
+
+  auto data = make_shared<Data>();
+  data->setName(interest->getName());
+  data->setFreshnessPeriod(::ndn::time::milliseconds(0));
+  data->setContent(make_shared< ::ndn::Buffer>(recorded->second));
+
+  Signature signature;
+  SignatureInfo signatureInfo(static_cast< ::ndn::tlv::SignatureTypeValue>(255));
+  signature.setInfo(signatureInfo);
+  signature.setValue(::ndn::makeNonNegativeIntegerBlock(::ndn::tlv::SignatureValue, 0));
+  data->setSignature(signature);
+
+  data->wireEncode();
+
+  m_transmittedDatas(data, this, m_face);
+  m_appLink->onReceiveData(*data);
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,98 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NDN_KITE_WORKLOAD_REPLAY_H
+#define NDN_KITE_WORKLOAD_REPLAY_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "ns3/ndnSIM/apps/ndn-app.hpp"
+
+#include "ns3/random-variable-stream.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+#include "kite-workload-recorder.h"
+
+#include <map>
+#include <set>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-apps
+ * @brief Ndn application that re-injects the workload recorded on one node by KiteWorkloadRecorder
+ *
+ * The Interests sent by the applications of node SourceNode are sent again at their recorded time,
+ * with their name, trace name, TraceFlag and lifetime, and Interests for names the applications answered
+ * are answered with Data of the recorded content size.  Together with one replay app per recorded node,
+ * this reproduces the packets a scenario puts onto the forwarders without its applications, wifi or mobility.
+ *
+ * The app announces the first component of every name its node received Interests for, see GetServedPrefixes().
+ */
+class KiteWorkloadReplay : public App {
+public:
+  static TypeId
+  GetTypeId();
+
+  KiteWorkloadReplay();
+
+  virtual void
+  OnInterest(shared_ptr<const Interest> interest);
+
+  /**
+   * @brief Nodes that sent or received packets in the given workload log
+   */
+  static std::set<uint32_t>
+  GetNodes(const std::string& file);
+
+  /**
+   * @brief Prefixes the replay app of the given node serves: the first component of every received name
+   */
+  static std::set<Name>
+  GetServedPrefixes(const std::string& file, uint32_t node);
+
+protected:
+  // inherited from Application base class.
+  virtual void
+  StartApplication();
+
+  virtual void
+  StopApplication();
+
+  void
+  SendNext();
+
+private:
+  std::string m_file;
+  uint32_t m_sourceNode;
+
+  Ptr<UniformRandomVariable> m_rand; ///< @brief nonce generator
+  std::vector<KiteWorkloadRecorder::Record> m_interests; ///< @brief Interests to send, by time
+  size_t m_next;
+  std::map<Name, uint32_t> m_datas;  ///< @brief content size of the Data the node answered, by name
+  EventId m_sendEvent;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_KITE_WORKLOAD_REPLAY_H
@@ -18,12 +18,15 @@
  **/
 
 #include "ndn-kite-upload-mobile.h"
+#include "ndn-kite-upload-server.h"
+#include "kite-trace-refresh.h"
 #include "ns3/log.h"
 #include "ns3/string.h"
 #include "ns3/boolean.h"
 #include "ns3/uinteger.h"
 #include "ns3/integer.h"
 #include "ns3/double.h"
+#include "ns3/pointer.h"
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 
@@ -61,6 +64,30 @@ KiteUploadMobile::GetTypeId(void)
                     MakeNameAccessor(&KiteUploadMobile::m_mobilePrefix), MakeNameChecker())
       .AddAttribute("InterestLifeTime", "LifeTime for traced Interest packet", StringValue("0.9s"),
                     MakeTimeAccessor(&KiteUploadMobile::m_interestLifeTime), MakeTimeChecker())
+      .AddAttribute("ObjectSize", "Number of segments of the object to upload, 0 for an endless stream",
+                    UintegerValue(0),
+                    MakeUintegerAccessor(&KiteUploadMobile::m_objectSize), MakeUintegerChecker<uint32_t>())
+      .AddAttribute("Manifest", "Publish a manifest of the object before its segments",
+                    BooleanValue(false),
+                    MakeBooleanAccessor(&KiteUploadMobile::m_useManifest), MakeBooleanChecker())
+      .AddAttribute("ShardCount", "Number of server shards, 0 if the server is not sharded",
+                    UintegerValue(0),
+                    MakeUintegerAccessor(&KiteUploadMobile::m_shardCount), MakeUintegerChecker<uint32_t>())
+      .AddAttribute("RequestSecret", "Secret shared with the server to derive the request token, 0 to send no token",
+                    UintegerValue(0),
+                    MakeUintegerAccessor(&KiteUploadMobile::m_requestSecret), MakeUintegerChecker<uint32_t>())
+      .AddAttribute("TraceInterval", "Interval between two upload requests", StringValue("1s"),
+                    MakeTimeAccessor(&KiteUploadMobile::m_traceInterval), MakeTimeChecker())
+      .AddAttribute("PiggybackRefresh", "Refresh the trace with the Data of a bulk upload instead of periodic requests",
+                    BooleanValue(false),
+                    MakeBooleanAccessor(&KiteUploadMobile::m_piggybackRefresh), MakeBooleanChecker())
+      .AddAttribute("PathCount", "Number of radios to keep a trace through, one per net device",
+                    UintegerValue(1),
+                    MakeUintegerAccessor(&KiteUploadMobile::m_pathCount), MakeUintegerChecker<uint32_t>(1))
+      .AddAttribute("HandoffPredictor", "Predictor of the entries into the range of the next access point",
+                    TypeId::ATTR_GET, PointerValue(),
+                    MakePointerAccessor(&KiteUploadMobile::m_predictor),
+                    MakePointerChecker<KiteHandoffPredictor>())
     ;
   return tid;
 }
@@ -68,6 +95,16 @@ KiteUploadMobile::GetTypeId(void)
 KiteUploadMobile::KiteUploadMobile()
   : m_rand(CreateObject<UniformRandomVariable>())
   , m_seq(0) 
+  , m_objectSize(0)
+  , m_useManifest(false)
+  , m_segmentSize(1024)
+  , m_shardCount(0)
+  , m_requestSecret(0)
+  , m_traceInterval(Seconds(1))
+  , m_pathCount(1)
+  , m_piggybackRefresh(false)
+  , m_refreshedDatas(0)
+  , m_predictor(CreateObject<KiteHandoffPredictor>())
 {
   NS_LOG_FUNCTION_NOARGS();
 }
@@ -78,7 +115,30 @@ KiteUploadMobile::StartApplication()
 {
   NS_LOG_FUNCTION_NOARGS();
   Producer::StartApplication();
+
+  UintegerValue payloadSize;
+  GetAttribute("PayloadSize", payloadSize);
+  m_segmentSize = payloadSize.Get();
+
+  if (m_useManifest && m_objectSize > 0) {
+    m_manifest = KiteManifest(m_mobilePrefix, m_objectSize, m_segmentSize);
+  }
+
+  if (m_pathCount > 1) {
+    // pin the request of every path to its own radio
+    Ptr<L3Protocol> l3 = GetNode()->GetObject<L3Protocol>();
+    for (uint32_t path = 0; path < m_pathCount && path < GetNode()->GetNDevices(); path++) {
+      shared_ptr<Face> face = l3->getFaceByNetDevice(GetNode()->GetDevice(path));
+      if (face == nullptr) {
+        NS_LOG_WARN("No face on net device " << path << ", its requests are not pinned");
+        continue;
+      }
+      FibHelper::AddRoute(GetNode(), GetPathPrefix(path), face, 0);
+    }
+  }
   
+  m_predictor->Start(GetNode(), MakeCallback(&KiteUploadMobile::SendHandoffTrace, this));
+
   SendTrace();
 }
 
@@ -87,6 +147,9 @@ KiteUploadMobile::StopApplication()
 {
   NS_LOG_FUNCTION_NOARGS();
 
+  m_predictor->Stop();
+  Simulator::Cancel(m_traceEvent);
+
   App::StopApplication();
 }
 
@@ -99,25 +162,78 @@ KiteUploadMobile::SendTrace()
 
   NS_LOG_FUNCTION_NOARGS();
 
-  shared_ptr<Name> name = make_shared<Name>(m_serverPrefix); // consumer is actually a stationary server under upload scenario
+  if (!m_active)
+    return;
+
+  // Send out trace at intervals equal to lifetime of trace, counting from the latest one
+  Simulator::Cancel(m_traceEvent);
+  m_traceEvent = Simulator::Schedule(m_traceInterval, &KiteUploadMobile::SendTrace, this);
+
+  if (m_refreshedDatas > 0) {
+    // still uploading, the Data sent since the last request kept the trace alive
+    NS_LOG_INFO("Trace refreshed by " << m_refreshedDatas << " Data packets, no request needed");
+    m_refreshedDatas = 0;
+    return;
+  }
 
-  shared_ptr<Interest> interest = make_shared<Interest>();
-  interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
-  interest->setName(*name);
-  interest->setTraceFlag(1);
-  time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
-  interest->setInterestLifetime(interestLifeTime);
+  for (uint32_t path = 0; path < m_pathCount; path++) {
+    shared_ptr<Name> name = make_shared<Name>(GetRequestName(path));
 
-  NS_LOG_INFO("> Traced Interest Name for No." << outCounter <<": " << name->toUri() << ", sent to Face: " << *m_face);
-  outCounter ++;
+    shared_ptr<Interest> interest = make_shared<Interest>();
+    interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+    interest->setName(*name);
+    interest->setTraceFlag(1);
+    time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
+    interest->setInterestLifetime(interestLifeTime);
 
-  Simulator::Schedule(Seconds(1), &KiteUploadMobile::SendTrace, this); // Send out trace at intervals equal to lifetime of trace
+    NS_LOG_INFO("> Traced Interest Name for No." << outCounter <<": " << name->toUri() << ", sent to Face: " << *m_face);
+    outCounter ++;
 
-  m_transmittedInterests(interest, this, m_face);
-  m_appLink->onReceiveInterest(*interest);
+    m_transmittedInterests(interest, this, m_face);
+    m_appLink->onReceiveInterest(*interest);
+  }
   //Send upload request.
 }
 
+void
+KiteUploadMobile::SendHandoffTrace()
+{
+  // the Data piggybacking refreshes follows the old trace, the new access point needs a request
+  m_refreshedDatas = 0;
+  SendTrace();
+}
+
+Name
+KiteUploadMobile::GetPathPrefix(uint32_t path) const
+{
+  Name name(m_serverPrefix); // consumer is actually a stationary server under upload scenario
+  if (m_shardCount > 0) {
+    name.append(std::to_string(KiteUploadServer::GetShard(m_mobilePrefix, m_shardCount)));
+  }
+  name.append(m_mobilePrefix); // tell the server whom to pull from
+  if (m_pathCount > 1) {
+    name.append("path").appendNumber(path);
+  }
+  return name;
+}
+
+Name
+KiteUploadMobile::GetRequestName(uint32_t path) const
+{
+  Name name = GetPathPrefix(path);
+  if (m_requestSecret != 0) {
+    name.append("token").appendNumber(KiteUploadServer::MakeRequestToken(m_mobilePrefix, m_requestSecret,
+                                                                         Simulator::Now()));
+  }
+  if (m_useManifest && m_objectSize > 0) {
+    name.append("manifest");
+  }
+  else if (m_objectSize > 0) {
+    name.append("bulk").appendNumber(m_objectSize);
+  }
+  return name;
+}
+
 void
 KiteUploadMobile::OnInterest(shared_ptr<const Interest> interest)
 {
@@ -131,7 +247,69 @@ KiteUploadMobile::OnInterest(shared_ptr<const Interest> interest)
     NS_LOG_INFO("Mobile: Receive normal Interest: " << interest->getName());
   }
 
-  //Producer::OnInterest(interest);
+  if (m_useManifest && m_objectSize > 0) {
+    App::OnInterest(interest); // tracing inside
+    if (!m_active)
+      return;
+
+    const Name& name = interest->getName();
+    Name traceName = interest->hasTraceName() ? interest->getTraceName() : Name();
+    Name objectName;
+    uint32_t manifestSegment = 0;
+    if (KiteManifest::parseManifestName(name, objectName, manifestSegment)) {
+      if (objectName == m_mobilePrefix && manifestSegment < m_manifest.getManifestSegmentCount()) {
+        const Block& manifest = m_manifest.wireEncode(manifestSegment);
+        SendData(name, make_shared< ::ndn::Buffer>(manifest.wire(), manifest.size()), traceName);
+      }
+    }
+    else if (name.size() == m_mobilePrefix.size() + 1 && m_mobilePrefix.isPrefixOf(name)
+             && name.at(-1).isSequenceNumber()) {
+      SendData(name, KiteManifest::makeSegmentContent(m_mobilePrefix, name.at(-1).toSequenceNumber(),
+                                                      m_segmentSize), traceName);
+    }
+    return;
+  }
+
+  if (m_piggybackRefresh && m_objectSize > 0 && interest->hasTraceName()) {
+    App::OnInterest(interest); // tracing inside
+    if (!m_active)
+      return;
+
+    SendData(interest->getName(), make_shared< ::ndn::Buffer>(m_segmentSize), interest->getTraceName());
+    return;
+  }
+
+  Producer::OnInterest(interest);
+}
+
+void
+KiteUploadMobile::SendData(const Name& dataName, shared_ptr< ::ndn::Buffer> content, const Name& traceName)
+{
+  auto data = make_shared<Data>();
+  data->setName(dataName);
+  data->setFreshnessPeriod(::ndn::time::milliseconds(0));
+  data->setContent(content);
+
+  if (m_piggybackRefresh && m_objectSize > 0 && !traceName.empty()) {
+    KiteTraceRefresh(traceName, time::milliseconds(m_interestLifeTime.GetMilliSeconds())).attachTo(*data);
+    m_refreshedDatas++;
+  }
+
+  Signature signature;
+  SignatureInfo signatureInfo(static_cast< ::ndn::tlv::SignatureTypeValue>(255));
+
+  signature.setInfo(signatureInfo);
+  signature.setValue(::ndn::makeNonNegativeIntegerBlock(::ndn::tlv::SignatureValue, 0));
+
+  data->setSignature(signature);
+
+  NS_LOG_INFO("node(" << GetNode()->GetId() << ") responding with Data: " << data->getName());
+
+  //to create real wire encoding
+  data->wireEncode();
+
+  m_transmittedDatas(data, this, m_face);
+  m_appLink->onReceiveData(*data);
 }
 
 void
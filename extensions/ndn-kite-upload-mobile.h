@@ -28,6 +28,10 @@
 
 #include "ns3/ndnSIM/apps/ndn-producer.hpp"
 
+#include "kite-handoff-predictor.h"
+
+#include "kite-manifest.h"
+
 namespace ns3 {
 namespace ndn {
 
@@ -39,6 +43,26 @@ namespace ndn {
  * It also sends out traces periodically to update it's location in the network.
  * In upload scenario, this should run on a mobile node, 
  * and the trace is actually Interest packet aimed at a stationary server to which data is uploaded.
+ *
+ * The traced Interest is named <ServerPrefix>/<MobilePrefix>, so that the server knows which mobile to pull from.
+ * When ObjectSize is set, the mobile uploads a single object of that many segments (bulk mode)
+ * and announces it as <ServerPrefix>/<MobilePrefix>/bulk/<ObjectSize>.
+ * With Manifest enabled as well, the object is described by a KiteManifest published under
+ * <MobilePrefix>/manifest/<k>, announced as <ServerPrefix>/<MobilePrefix>/manifest,
+ * and segments carry the content listed in the manifest.
+ * With ShardCount set, the request goes to the shard owning the mobile,
+ * <ServerPrefix>/<shard>/<MobilePrefix>, see KiteUploadServer::GetShard().
+ * With PathCount above 1, the mobile keeps one trace per radio: the request for path k is named
+ * <MobilePrefix>/path/<k> before the bulk or manifest marker and leaves through the k-th net device of the node.
+ * With RequestSecret set, every request carries /token/<KiteUploadServer::MakeRequestToken()> before the bulk
+ * or manifest marker, for servers that only admit mobiles knowing their TokenSecret.
+ * With PiggybackRefresh enabled, every Data answering a tracing Interest carries a KiteTraceRefresh marker
+ * for the trace it came down, and a periodic request is only sent if no Data left the mobile since the
+ * previous one.  This only applies to bulk and manifest uploads: in stream mode each request makes the
+ * server pull one more segment, so requests are always sent.
+ *
+ * With access points set on its HandoffPredictor, the mobile sends an extra traced Interest at the moment
+ * it is expected to come within range of the next access point, see KiteHandoffPredictor.
  */
 class KiteUploadMobile : public Producer {
 public:
@@ -74,6 +98,32 @@ protected:
   std::string
   GetRandomize() const;
 
+  /**
+   * @brief Schedule-able SendTrace() that is never replaced by piggybacked refreshes
+   */
+  void
+  SendHandoffTrace();
+
+  /**
+   * @brief Answer an Interest with a Data packet carrying the given content
+   *
+   * With PiggybackRefresh enabled and a non-empty traceName, the Data also refreshes that trace.
+   */
+  void
+  SendData(const Name& dataName, shared_ptr< ::ndn::Buffer> content, const Name& traceName = Name());
+
+  /**
+   * @brief Upload request name up to the path marker, requests under it leave through the path's radio
+   */
+  Name
+  GetPathPrefix(uint32_t path) const;
+
+  /**
+   * @brief Name of the upload request sent over the given path
+   */
+  Name
+  GetRequestName(uint32_t path) const;
+
 private:
   Name m_serverPrefix;
   Name m_mobilePrefix;
@@ -84,6 +134,19 @@ private:
   std::string m_randomType;
   
   int m_seq;
+  uint32_t m_objectSize; ///< @brief number of segments of the uploaded object, 0 for an endless stream
+  bool m_useManifest;
+  uint32_t m_segmentSize;
+  KiteManifest m_manifest;
+  uint32_t m_shardCount;
+  uint32_t m_requestSecret;
+  Time m_traceInterval;
+  uint32_t m_pathCount;
+  EventId m_traceEvent;
+  bool m_piggybackRefresh;
+  uint32_t m_refreshedDatas; ///< @brief Data sent with a refresh marker since the last SendTrace()
+
+  Ptr<KiteHandoffPredictor> m_predictor;
 };
 
 } // namespace ndn
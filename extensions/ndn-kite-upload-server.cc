@@ -28,9 +28,15 @@
 #include "ns3/uinteger.h"
 #include "ns3/integer.h"
 #include "ns3/double.h"
+#include "ns3/pointer.h"
+#include "ns3/config.h"
+#include "ns3/trace-helper.h"
 
 #include "helper/ndn-fib-helper.hpp"
 
+#include <cstdlib>
+#include <sstream>
+
 NS_LOG_COMPONENT_DEFINE("ndn.kite.KiteUploadServer");
 
 namespace ns3 {
@@ -38,6 +44,9 @@ namespace ndn {
 
 NS_OBJECT_ENSURE_REGISTERED(KiteUploadServer);
 
+const size_t KiteUploadServer::MAX_BUCKETS = 1024;
+const Time KiteUploadServer::TOKEN_WINDOW = Seconds(10);
+
 TypeId
 KiteUploadServer::GetTypeId(void)
 {
@@ -57,12 +66,138 @@ KiteUploadServer::GetTypeId(void)
                     IntegerValue(std::numeric_limits<uint32_t>::max()),
                     MakeIntegerAccessor(&KiteUploadServer::m_seqMax), MakeIntegerChecker<uint32_t>())
 
+      .AddAttribute("Window", "Number of outstanding tracing Interests per bulk upload",
+                    UintegerValue(8),
+                    MakeUintegerAccessor(&KiteUploadServer::m_window), MakeUintegerChecker<uint32_t>(1))
+
+      .AddAttribute("ReissueOnRefresh",
+                    "Re-send outstanding tracing Interests over the new trace whenever an upload request arrives",
+                    BooleanValue(true),
+                    MakeBooleanAccessor(&KiteUploadServer::m_reissueOnRefresh), MakeBooleanChecker())
+
+      .AddAttribute("ShardCount", "Number of server instances sharing the mobiles, 0 if not sharded",
+                    UintegerValue(0),
+                    MakeUintegerAccessor(&KiteUploadServer::m_shardCount), MakeUintegerChecker<uint32_t>())
+
+      .AddAttribute("ShardIndex", "Shard served by this instance",
+                    UintegerValue(0),
+                    MakeUintegerAccessor(&KiteUploadServer::m_shardIndex), MakeUintegerChecker<uint32_t>())
+
+      .AddAttribute("RequestRate", "Upload requests per second admitted from every mobile, 0 for no limit",
+                    DoubleValue(0.0),
+                    MakeDoubleAccessor(&KiteUploadServer::m_requestRate), MakeDoubleChecker<double>(0.0))
+
+      .AddAttribute("RequestBurst", "Upload requests a mobile may send at once under RequestRate",
+                    UintegerValue(4),
+                    MakeUintegerAccessor(&KiteUploadServer::m_requestBurst), MakeUintegerChecker<uint32_t>(1))
+
+      .AddAttribute("MaxPending", "Outstanding tracing Interests over all mobiles, 0 for no limit",
+                    UintegerValue(0),
+                    MakeUintegerAccessor(&KiteUploadServer::m_maxPending), MakeUintegerChecker<uint32_t>())
+
+      .AddAttribute("TokenSecret", "Secret shared with the mobiles to derive request tokens, 0 if no token is needed",
+                    UintegerValue(0),
+                    MakeUintegerAccessor(&KiteUploadServer::m_tokenSecret), MakeUintegerChecker<uint32_t>())
+
+      .AddAttribute("Weights", "Whitespace separated <mobile prefix>:<weight> pairs, mobiles not listed weigh 1",
+                    StringValue(""),
+                    MakeStringAccessor(&KiteUploadServer::SetWeights, &KiteUploadServer::GetWeights),
+                    MakeStringChecker())
+
+      .AddAttribute("ServiceQueue", "Service model in front of the Interest and Data handling of the server",
+                    TypeId::ATTR_GET, PointerValue(),
+                    MakePointerAccessor(&KiteUploadServer::m_serviceQueue),
+                    MakePointerChecker<KiteServiceQueue>())
+
+      .AddTraceSource("UploadCompleted", "A bulk upload has received all its segments",
+                      MakeTraceSourceAccessor(&KiteUploadServer::m_uploadCompleted),
+                      "ns3::ndn::KiteUploadServer::UploadCompletedCallback")
+
+      .AddTraceSource("PathCompleted", "Bytes received over one path of a completed bulk upload",
+                      MakeTraceSourceAccessor(&KiteUploadServer::m_pathCompleted),
+                      "ns3::ndn::KiteUploadServer::PathCompletedCallback")
+
+      .AddTraceSource("RequestAdmission", "An upload request has been admitted or rejected",
+                      MakeTraceSourceAccessor(&KiteUploadServer::m_requestAdmission),
+                      "ns3::ndn::KiteUploadServer::RequestAdmissionCallback")
+
     ;
 
   return tid;
 }
 
+KiteUploadServer::UploadRequest::UploadRequest()
+  : objectSize(0)
+  , manifest(false)
+  , path(0)
+  , hasToken(false)
+  , token(0)
+{
+}
+
+KiteUploadServer::TokenBucket::TokenBucket()
+  : tokens(0.0)
+{
+}
+
+KiteUploadServer::UploadPath::UploadPath()
+  : outstanding(0)
+  , receivedBytes(0)
+  , broken(false)
+{
+}
+
+KiteUploadServer::UploadSession::UploadSession()
+  : objectSize(0)
+  , window(0)
+  , maxWindow(0)
+  , windowCredit(0)
+  , nextSeq(0)
+  , received(0)
+  , receivedBytes(0)
+  , complete(false)
+  , weight(1.0)
+  , deficit(0.0)
+  , awaitingManifest(false)
+{
+}
+
+void
+KiteUploadServer::UploadSession::UpdateRtt(Time sample)
+{
+  // RFC 6298 smoothing
+  if (srtt.IsZero()) {
+    srtt = sample;
+    rttvar = sample / 2;
+  }
+  else {
+    Time delta = srtt > sample ? srtt - sample : sample - srtt;
+    rttvar = (rttvar * 3 + delta) / 4;
+    srtt = (srtt * 7 + sample) / 8;
+  }
+}
+
+Time
+KiteUploadServer::UploadSession::GetRto(Time maxRto) const
+{
+  if (srtt.IsZero())
+    return maxRto;
+
+  return std::min(srtt + rttvar * 4, maxRto);
+}
+
 KiteUploadServer::KiteUploadServer()
+  : m_window(8)
+  , m_reissueOnRefresh(true)
+  , m_shardCount(0)
+  , m_shardIndex(0)
+  , m_requestRate(0.0)
+  , m_requestBurst(4)
+  , m_maxPending(0)
+  , m_tokenSecret(0)
+  , m_admittedRequests(0)
+  , m_rejectedRequests(0)
+  , m_serviceQueue(CreateObject<KiteServiceQueue>())
 {
   NS_LOG_FUNCTION_NOARGS();
   m_seq = 0;
@@ -76,11 +211,251 @@ KiteUploadServer::StartApplication()
   NS_LOG_FUNCTION_NOARGS();
   App::StartApplication();
 
-  FibHelper::AddRoute(GetNode(), m_serverPrefix, m_face, 0);
+  if (m_shardCount > 0 && m_shardIndex >= m_shardCount) {
+    NS_FATAL_ERROR("ShardIndex " << m_shardIndex << " is not below ShardCount " << m_shardCount);
+  }
+
+  m_servedPrefix = m_serverPrefix;
+  if (m_shardCount > 0) {
+    m_servedPrefix.append(std::to_string(m_shardIndex));
+  }
+
+  FibHelper::AddRoute(GetNode(), m_servedPrefix, m_face, 0);
+}
+
+void
+KiteUploadServer::StopApplication()
+{
+  NS_LOG_FUNCTION_NOARGS();
+
+  NS_LOG_INFO("node(" << GetNode()->GetId() << ") admitted " << m_admittedRequests << " upload requests, rejected "
+              << m_rejectedRequests);
+
+  m_sessionTimeoutEvent.Cancel();
+
+  Consumer::StopApplication();
+}
+
+uint32_t
+KiteUploadServer::GetShard(const Name& mobilePrefix, uint32_t shardCount)
+{
+  // FNV-1a, stable across runs and platforms unlike std::hash
+  uint32_t hash = 2166136261u;
+  for (char c : mobilePrefix.toUri()) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 16777619u;
+  }
+  return hash % shardCount;
+}
+
+uint32_t
+KiteUploadServer::MakeRequestToken(const Name& mobilePrefix, uint32_t secret, Time time)
+{
+  uint32_t window = static_cast<uint32_t>(time.GetMilliSeconds() / TOKEN_WINDOW.GetMilliSeconds());
+
+  uint32_t hash = 2166136261u;
+  for (int i = 0; i < 4; i++) {
+    hash ^= (secret >> (8 * i)) & 0xff;
+    hash *= 16777619u;
+  }
+  for (int i = 0; i < 4; i++) {
+    hash ^= (window >> (8 * i)) & 0xff;
+    hash *= 16777619u;
+  }
+  for (char c : mobilePrefix.toUri()) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+bool
+KiteUploadServer::AdmitRequest(const UploadRequest& request)
+{
+  bool admitted = true;
+
+  // a request sent just before the window changed may arrive in the next one
+  if (m_tokenSecret != 0
+      && (!request.hasToken
+          || (request.token != MakeRequestToken(request.mobilePrefix, m_tokenSecret, Simulator::Now())
+              && request.token != MakeRequestToken(request.mobilePrefix, m_tokenSecret,
+                                                   Simulator::Now() - TOKEN_WINDOW)))) {
+    NS_LOG_INFO("node(" << GetNode()->GetId() << ") rejects upload request of " << request.mobilePrefix
+                << ", bad request token");
+    admitted = false;
+  }
+  else if (m_requestRate > 0) {
+    auto inserted = m_buckets.insert(std::make_pair(request.mobilePrefix, TokenBucket()));
+    TokenBucket& bucket = inserted.first->second;
+    if (inserted.second) {
+      if (m_buckets.size() > MAX_BUCKETS) {
+        // forget the mobile heard from least recently, a flood of new prefixes costs constant time per request
+        m_buckets.erase(m_bucketOrder.front());
+        m_bucketOrder.pop_front();
+      }
+      bucket.tokens = m_requestBurst;
+      bucket.position = m_bucketOrder.insert(m_bucketOrder.end(), request.mobilePrefix);
+    }
+    else {
+      m_bucketOrder.splice(m_bucketOrder.end(), m_bucketOrder, bucket.position);
+      bucket.tokens += (Simulator::Now() - bucket.lastRefill).ToDouble(Time::S) * m_requestRate;
+      bucket.tokens = std::min(bucket.tokens, static_cast<double>(m_requestBurst));
+    }
+    bucket.lastRefill = Simulator::Now();
+
+    if (bucket.tokens < 1.0) {
+      NS_LOG_INFO("node(" << GetNode()->GetId() << ") rejects upload request of " << request.mobilePrefix
+                  << ", over " << m_requestRate << " requests/s");
+      admitted = false;
+    }
+    else {
+      bucket.tokens -= 1.0;
+    }
+  }
+
+  if (admitted)
+    m_admittedRequests++;
+  else
+    m_rejectedRequests++;
+
+  m_requestAdmission(request.mobilePrefix, admitted);
+  return admitted;
+}
+
+bool
+KiteUploadServer::CheckUploadRequest(shared_ptr<const Interest> interest, UploadRequest& request)
+{
+  bool parsed = ParseUploadRequest(interest->getName(), request);
+  if (m_shardCount > 0 && parsed && GetShard(request.mobilePrefix, m_shardCount) != m_shardIndex) {
+    NS_LOG_INFO("node(" << GetNode()->GetId() << ") ignores upload request of " << request.mobilePrefix
+                << ", not in shard " << m_shardIndex);
+    return false;
+  }
+
+  if (!parsed) {
+    request.mobilePrefix = m_interestName;
+  }
+  return AdmitRequest(request);
+}
+
+uint32_t
+KiteUploadServer::GetPendingCount() const
+{
+  uint32_t pending = m_seqTimeouts.size();
+  for (const auto& session : m_sessions) {
+    pending += session.second.pending.size() + session.second.manifestPending.size();
+  }
+  return pending;
+}
+
+bool
+KiteUploadServer::CanSendMore() const
+{
+  return m_maxPending == 0 || GetPendingCount() < m_maxPending;
+}
+
+void
+KiteUploadServer::SetWeights(const std::string& value)
+{
+  m_weightsString = value;
+  m_weights.clear();
+
+  std::istringstream is(value);
+  std::string item;
+  while (is >> item) {
+    size_t separator = item.rfind(':');
+    if (separator == std::string::npos) {
+      NS_LOG_WARN("Ignoring weight without separator: " << item);
+      continue;
+    }
+
+    double weight = std::atof(item.substr(separator + 1).c_str());
+    if (weight <= 0) {
+      NS_LOG_WARN("Ignoring non-positive weight: " << item);
+      continue;
+    }
+    m_weights[Name(item.substr(0, separator))] = weight;
+  }
+}
+
+std::string
+KiteUploadServer::GetWeights() const
+{
+  return m_weightsString;
+}
+
+double
+KiteUploadServer::GetJainIndex(const std::vector<double>& values)
+{
+  double sum = 0;
+  double squares = 0;
+  for (double value : values) {
+    sum += value;
+    squares += value * value;
+  }
+
+  if (squares == 0)
+    return 1.0; // nobody got anything, equally
+
+  return sum * sum / (values.size() * squares);
+}
+
+void
+KiteUploadServer::ReportFairness(std::ostream& os) const
+{
+  std::vector<double> throughputs;
+  for (const auto& item : m_sessions) {
+    const UploadSession& session = item.second;
+    Time duration = (session.complete ? session.finishTime : Simulator::Now()) - session.startTime;
+    double throughput = duration.IsPositive() ? session.receivedBytes * 8 / duration.ToDouble(Time::S) / 1000 : 0;
+    // weighted fair share is throughput proportional to weight
+    throughputs.push_back(throughput / session.weight);
+
+    os << GetNode()->GetId() << "\t" << session.mobilePrefix << "\t" << session.weight << "\t"
+       << session.receivedBytes << "\t" << throughput << std::endl;
+  }
+
+  if (!throughputs.empty()) {
+    os << GetNode()->GetId() << "\tJain\t-\t-\t" << GetJainIndex(throughputs) << std::endl;
+  }
+}
+
+static void
+UploadCompleted(Ptr<OutputStreamWrapper> stream, const Name& mobilePrefix, uint32_t segments,
+                uint64_t bytes, Time completionTime)
+{
+  *stream->GetStream() << Simulator::Now().ToDouble(Time::S) << "\t" << mobilePrefix << "\t"
+                       << segments << "\t" << bytes << "\t" << completionTime.ToDouble(Time::S) << "\t"
+                       << (bytes * 8 / completionTime.ToDouble(Time::S) / 1000) << std::endl;
+}
+
+void
+KiteUploadServer::TraceCompletions(const std::string& file)
+{
+  AsciiTraceHelper asciiTraceHelper;
+  Ptr<OutputStreamWrapper> stream = asciiTraceHelper.CreateFileStream(file);
+  *stream->GetStream() << "Time\tMobile\tSegments\tBytes\tCompletionTime\tGoodput" << std::endl;
+  Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/$ns3::ndn::KiteUploadServer/UploadCompleted",
+                                MakeBoundCallback(&UploadCompleted, stream));
 }
 
 void
 KiteUploadServer::OnInterest(shared_ptr<const Interest> interest)
+{
+  // upload requests are admitted before they take a place in the service queue, a flood costs no service time
+  if (m_active && interest->getTraceFlag() == 1) {
+    UploadRequest request;
+    if (!CheckUploadRequest(interest, request))
+      return;
+  }
+
+  if (!m_serviceQueue->Enqueue(std::bind(&KiteUploadServer::ProcessInterest, this, interest))) {
+    NS_LOG_INFO("node(" << GetNode()->GetId() << ") is overloaded, dropping Interest " << interest->getName());
+  }
+}
+
+void
+KiteUploadServer::ProcessInterest(shared_ptr<const Interest> interest)
 {
   App::OnInterest(interest); // tracing inside
   NS_LOG_INFO ("Server: m_interestName: " << m_interestName);
@@ -103,7 +478,18 @@ KiteUploadServer::OnInterest(shared_ptr<const Interest> interest)
   
 
   if (interest->getTraceFlag() == 1) {
-    SendInterest(interest, 2); // send out a traceOnly Interest packet
+    UploadRequest request;
+    bool parsed = ParseUploadRequest(interest->getName(), request);
+    if (!parsed) {
+      request.mobilePrefix = m_interestName;
+    }
+
+    if (parsed && (request.objectSize > 0 || request.manifest)) {
+      OnBulkRequest(interest, request);
+    }
+    else {
+      SendInterest(interest, 2); // send out a traceOnly Interest packet
+    }
   }
   else{
     //Return Data to the interest-requester.
@@ -143,12 +529,25 @@ KiteUploadServer::SendInterest(shared_ptr<const Interest> tracedInterest, uint8_
 
   NS_LOG_INFO("node(" << GetNode()->GetId() << ") received IFI with name: " << tracedInterest->getName() << ", Nonce: " << tracedInterest->getNonce());
 
-  /*uint32_t seq = std::numeric_limits<uint32_t>::max(); // invalid
+  if (!CanSendMore()) {
+    NS_LOG_INFO("node(" << GetNode()->GetId() << ") has " << m_maxPending << " tracing Interests outstanding, ignoring request");
+    return;
+  }
+
+  UploadRequest request;
+  if (!ParseUploadRequest(tracedInterest->getName(), request)) {
+    request.mobilePrefix = m_interestName;
+  }
+  UploadStream& stream = m_streams[request.mobilePrefix];
+
+  uint32_t seq = std::numeric_limits<uint32_t>::max(); // invalid
 
-  while (m_retxSeqs.size()) {
-    seq = *m_retxSeqs.begin();
-    m_retxSeqs.erase(m_retxSeqs.begin());
-    break;
+  // sequence numbers are shared by all mobiles, only retransmit those of the requesting one
+  for (const auto& outstanding : stream.outstanding) {
+    if (m_retxSeqs.erase(outstanding.first) > 0) {
+      seq = outstanding.first;
+      break;
+    }
   }
 
   if (seq == std::numeric_limits<uint32_t>::max()) {
@@ -159,10 +558,39 @@ KiteUploadServer::SendInterest(shared_ptr<const Interest> tracedInterest, uint8_
     }
 
     seq = m_seq++;
-  }*/
-  uint32_t seq = m_seq++;
+  }
+
+  if (m_reissueOnRefresh) {
+    // whatever this mobile was sent before its previous request may be stuck on the old trace
+    std::vector<uint32_t> stale;
+    for (const auto& outstanding : stream.outstanding) {
+      if (outstanding.second <= stream.lastRequest && outstanding.first != seq
+          && m_seqTimeouts.find(outstanding.first) != m_seqTimeouts.end()) {
+        stale.push_back(outstanding.first);
+      }
+    }
+    for (uint32_t staleSeq : stale) {
+      NS_LOG_DEBUG("Reissuing " << staleSeq << " of " << request.mobilePrefix << " over the refreshed trace");
+      m_seqTimeouts.erase(staleSeq);
+      SendStreamInterest(tracedInterest, staleSeq, traceFlag);
+    }
+  }
+  stream.lastRequest = Simulator::Now();
+
+  SendStreamInterest(tracedInterest, seq, traceFlag);
+
+  ScheduleNextPacket();
+}
+
+void
+KiteUploadServer::SendStreamInterest(shared_ptr<const Interest> tracedInterest, uint32_t seq, uint8_t traceFlag)
+{
+  UploadRequest request;
+  if (!ParseUploadRequest(tracedInterest->getName(), request)) {
+    request.mobilePrefix = m_interestName;
+  }
 
-  shared_ptr<Name> nameWithSequence = make_shared<Name>(m_interestName);
+  shared_ptr<Name> nameWithSequence = make_shared<Name>(request.mobilePrefix);
   nameWithSequence->appendSequenceNumber(seq);
 
   shared_ptr<Interest> interest = make_shared<Interest>();
@@ -179,12 +607,567 @@ KiteUploadServer::SendInterest(shared_ptr<const Interest> tracedInterest, uint8_
 
   NS_LOG_INFO("> Interest for " << seq << ", Name: " << interest->getName() << ", TraceName: " << interest->getTraceName());
 
+  m_streams[request.mobilePrefix].outstanding[seq] = Simulator::Now();
   WillSendOutInterest(seq);
 
   m_transmittedInterests(interest, this, m_face);
   m_appLink->onReceiveInterest(*interest);
+}
 
-  ScheduleNextPacket();
+bool
+KiteUploadServer::ParseUploadRequest(const Name& requestName, UploadRequest& request) const
+{
+  if (!m_servedPrefix.isPrefixOf(requestName) || requestName.size() == m_servedPrefix.size())
+    return false;
+
+  Name name = requestName.getSubName(m_servedPrefix.size());
+
+  if (name.size() >= 1 && name.get(-1) == ::ndn::name::Component("manifest")) {
+    request.manifest = true;
+    name = name.getPrefix(-1);
+  }
+  else if (name.size() >= 2 && name.get(-2) == ::ndn::name::Component("bulk") && name.get(-1).isNumber()) {
+    request.objectSize = name.get(-1).toNumber();
+    name = name.getPrefix(-2);
+  }
+
+  if (name.size() >= 2 && name.get(-2) == ::ndn::name::Component("token") && name.get(-1).isNumber()) {
+    request.hasToken = true;
+    request.token = name.get(-1).toNumber();
+    name = name.getPrefix(-2);
+  }
+
+  if (name.size() >= 2 && name.get(-2) == ::ndn::name::Component("path") && name.get(-1).isNumber()) {
+    request.path = name.get(-1).toNumber();
+    name = name.getPrefix(-2);
+  }
+
+  if (name.empty())
+    return false;
+
+  request.mobilePrefix = name;
+  return true;
+}
+
+void
+KiteUploadServer::OnBulkRequest(shared_ptr<const Interest> tracedInterest, const UploadRequest& request)
+{
+  auto it = m_sessions.find(request.mobilePrefix);
+  if (it == m_sessions.end()) {
+    UploadSession session;
+    session.mobilePrefix = request.mobilePrefix;
+    session.objectSize = request.objectSize;
+    session.window = m_window;
+    session.maxWindow = m_window;
+    session.startTime = Simulator::Now();
+    session.receivedSeqs.assign(request.objectSize, false);
+    session.awaitingManifest = request.manifest;
+    auto weight = m_weights.find(request.mobilePrefix);
+    if (weight != m_weights.end()) {
+      session.weight = weight->second;
+    }
+    it = m_sessions.insert(std::make_pair(request.mobilePrefix, session)).first;
+
+    NS_LOG_INFO("node(" << GetNode()->GetId() << ") starts bulk upload from " << request.mobilePrefix
+                << (request.manifest ? " (manifest)" : ""));
+  }
+
+  if (!it->second.complete && !m_sessionTimeoutEvent.IsRunning()) {
+    m_sessionTimeoutEvent = Simulator::Schedule(m_retxTimer, &KiteUploadServer::CheckSessionTimeouts, this);
+  }
+
+  UploadSession& session = it->second;
+  if (session.complete)
+    return;
+
+  // the latest upload request carries the freshest trace
+  session.traceName = tracedInterest->getName();
+
+  UploadPath& path = session.paths[request.path];
+  Time previousRequest = path.lastRequest;
+  path.traceName = tracedInterest->getName();
+  path.lastRequest = Simulator::Now();
+  path.broken = false;
+
+  if (session.awaitingManifest) {
+    if (m_reissueOnRefresh) {
+      // manifest segments requested over the previous trace are requested again over this one
+      for (auto pending = session.manifestPending.begin(); pending != session.manifestPending.end();) {
+        if (pending->second <= previousRequest)
+          pending = session.manifestPending.erase(pending);
+        else
+          ++pending;
+      }
+    }
+    FetchManifest(session);
+    return;
+  }
+
+  if (m_reissueOnRefresh) {
+    ReissueOutstanding(session, request.path, previousRequest);
+  }
+  ScheduleSessions();
+}
+
+void
+KiteUploadServer::ReissueOutstanding(UploadSession& session, uint32_t pathId, Time since)
+{
+  std::vector<uint32_t> stale;
+  for (const auto& pending : session.pending) {
+    // sent over the previous trace of this path, and should have been answered by now
+    if (session.segmentPaths[pending.first] == pathId && pending.second <= since
+        && pending.second + session.srtt <= Simulator::Now()) {
+      stale.push_back(pending.first);
+    }
+  }
+
+  for (uint32_t seq : stale) {
+    NS_LOG_DEBUG("Reissuing segment " << seq << " of " << session.mobilePrefix << " over the refreshed trace");
+    ReleaseSegment(session, seq);
+    session.retransmitted.insert(seq);
+    SendTracingInterest(session, seq, pathId); // replaces the pending entry, Data of either copy completes it
+  }
+}
+
+void
+KiteUploadServer::FetchManifest(UploadSession& session)
+{
+  // after a Nack, the manifest waits for the next upload request and its fresh trace
+  for (const auto& path : session.paths) {
+    if (path.second.traceName == session.traceName && path.second.broken)
+      return;
+  }
+
+  // only the first segment of the manifest tells how many there are
+  uint32_t manifestSegments = session.manifest != nullptr ? session.manifest->getManifestSegmentCount() : 1;
+
+  for (uint32_t manifestSegment = 0;
+       manifestSegment < manifestSegments && session.manifestPending.size() < session.window && CanSendMore();
+       manifestSegment++) {
+    if (session.manifestPending.count(manifestSegment) > 0
+        || (session.manifest != nullptr && session.manifest->hasManifestSegment(manifestSegment)))
+      continue;
+
+    SendManifestInterest(session, manifestSegment);
+  }
+}
+
+void
+KiteUploadServer::SendManifestInterest(UploadSession& session, uint32_t manifestSegment)
+{
+  if (!m_active)
+    return;
+
+  shared_ptr<Interest> interest = make_shared<Interest>();
+  interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+  interest->setName(KiteManifest::getManifestName(session.mobilePrefix, manifestSegment));
+  interest->setTraceName(session.traceName);
+  time::milliseconds interestLifeTime(m_tracingInterestLifeTime.GetMilliSeconds());
+  interest->setInterestLifetime(interestLifeTime);
+  interest->setTraceFlag(2);
+
+  session.manifestPending[manifestSegment] = Simulator::Now();
+
+  NS_LOG_INFO("> Manifest Interest, Name: " << interest->getName() << ", TraceName: " << interest->getTraceName());
+
+  m_transmittedInterests(interest, this, m_face);
+  m_appLink->onReceiveInterest(*interest);
+}
+
+void
+KiteUploadServer::OnManifest(UploadSession& session, uint32_t manifestSegment, shared_ptr<const Data> data)
+{
+  if (!session.awaitingManifest)
+    return; // duplicate
+
+  auto pending = session.manifestPending.find(manifestSegment);
+  if (pending != session.manifestPending.end()) {
+    session.UpdateRtt(Simulator::Now() - pending->second);
+    session.manifestPending.erase(pending);
+  }
+
+  shared_ptr<KiteManifest> part;
+  try {
+    part = make_shared<KiteManifest>(data->getContent().blockFromValue());
+  }
+  catch (const ::ndn::tlv::Error& error) {
+    NS_LOG_WARN("Malformed manifest segment " << manifestSegment << " from " << session.mobilePrefix << ": "
+                << error.what());
+    FetchManifest(session);
+    return;
+  }
+
+  if (session.manifest == nullptr) {
+    session.manifest = part;
+  }
+  else if (!session.manifest->merge(*part)) {
+    NS_LOG_WARN("Manifest segment " << manifestSegment << " from " << session.mobilePrefix
+                << " describes another object");
+    FetchManifest(session);
+    return;
+  }
+
+  if (!session.manifest->isComplete()) {
+    FetchManifest(session);
+    return;
+  }
+
+  const shared_ptr<KiteManifest>& manifest = session.manifest;
+  session.awaitingManifest = false;
+  session.objectSize = manifest->getSegmentCount();
+  session.receivedSeqs.assign(session.objectSize, false);
+  // no need to probe: the whole object is known, so fetch all of it in parallel up to the window limit
+  session.window = std::max<uint32_t>(1, std::min(m_window, session.objectSize));
+  session.maxWindow = session.window;
+
+  NS_LOG_INFO("node(" << GetNode()->GetId() << ") received manifest of " << session.mobilePrefix << ": "
+              << session.objectSize << " segments of " << manifest->getSegmentSize() << " bytes");
+
+  if (session.objectSize == 0) {
+    session.complete = true;
+    session.finishTime = Simulator::Now();
+    m_uploadCompleted(session.mobilePrefix, 0, 0, Simulator::Now() - session.startTime);
+    return;
+  }
+  ScheduleSessions();
+}
+
+void
+KiteUploadServer::ScheduleSessions()
+{
+  if (!m_active || m_sessions.empty())
+    return;
+
+  // deficit round-robin, every round a session may send Weight more segments,
+  // starting after the session served last so that no prefix is favored by its position in the map
+  bool eligible = true;
+  while (eligible && CanSendMore()) {
+    eligible = false;
+
+    auto item = m_sessions.upper_bound(m_lastScheduled);
+    for (size_t i = 0; i < m_sessions.size() && CanSendMore(); i++, ++item) {
+      if (item == m_sessions.end())
+        item = m_sessions.begin();
+
+      UploadSession& session = item->second;
+      if (!CanSendSegment(session)) {
+        session.deficit = 0; // an idle session does not save up for later
+        continue;
+      }
+
+      eligible = true;
+      session.deficit += session.weight;
+      while (session.deficit >= 1.0 && CanSendMore() && SendNextSegment(session)) {
+        session.deficit -= 1.0;
+        m_lastScheduled = item->first;
+      }
+
+      if (!CanSendSegment(session)) {
+        session.deficit = 0;
+      }
+    }
+  }
+}
+
+bool
+KiteUploadServer::CanSendSegment(const UploadSession& session) const
+{
+  if (session.complete || session.awaitingManifest || session.pending.size() >= session.window)
+    return false;
+
+  if (session.retxSeqs.empty() && session.nextSeq >= session.objectSize)
+    return false; // everything is either received or outstanding
+
+  // wait for the mobile to refresh a trace
+  return SelectPath(session) != std::numeric_limits<uint32_t>::max();
+}
+
+bool
+KiteUploadServer::SendNextSegment(UploadSession& session)
+{
+  if (!CanSendSegment(session))
+    return false;
+
+  uint32_t path = SelectPath(session);
+  uint32_t seq = std::numeric_limits<uint32_t>::max(); // invalid
+
+  if (!session.retxSeqs.empty()) {
+    seq = *session.retxSeqs.begin();
+    session.retxSeqs.erase(session.retxSeqs.begin());
+  }
+  else {
+    seq = session.nextSeq++;
+  }
+
+  SendTracingInterest(session, seq, path);
+  return true;
+}
+
+uint32_t
+KiteUploadServer::SelectPath(const UploadSession& session) const
+{
+  uint32_t selected = std::numeric_limits<uint32_t>::max();
+  uint32_t latest = std::numeric_limits<uint32_t>::max();
+  Time latestRequest;
+
+  for (const auto& item : session.paths) {
+    const UploadPath& path = item.second;
+    if (path.broken)
+      continue;
+
+    if (latest == std::numeric_limits<uint32_t>::max() || path.lastRequest >= latestRequest) {
+      latest = item.first;
+      latestRequest = path.lastRequest;
+    }
+
+    // a path that has not been refreshed for a lifetime has most likely been lost in a handoff
+    if (path.lastRequest + m_tracingInterestLifeTime < Simulator::Now())
+      continue;
+
+    if (selected == std::numeric_limits<uint32_t>::max()
+        || path.outstanding < session.paths.at(selected).outstanding) {
+      selected = item.first;
+    }
+  }
+
+  return selected != std::numeric_limits<uint32_t>::max() ? selected : latest;
+}
+
+void
+KiteUploadServer::SendTracingInterest(UploadSession& session, uint32_t seq, uint32_t pathId)
+{
+  if (!m_active)
+    return;
+
+  UploadPath& path = session.paths[pathId];
+
+  shared_ptr<Name> nameWithSequence = make_shared<Name>(session.mobilePrefix);
+  nameWithSequence->appendSequenceNumber(seq);
+
+  shared_ptr<Interest> interest = make_shared<Interest>();
+  interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+  interest->setName(*nameWithSequence);
+  interest->setTraceName(path.traceName);
+  time::milliseconds interestLifeTime(m_tracingInterestLifeTime.GetMilliSeconds());
+  interest->setInterestLifetime(interestLifeTime);
+  interest->setTraceFlag(2);
+
+  session.pending[seq] = Simulator::Now();
+  session.segmentPaths[seq] = pathId;
+  path.outstanding++;
+
+  NS_LOG_INFO("> Bulk Interest for " << seq << " over path " << pathId << ", Name: " << interest->getName() << ", TraceName: " << interest->getTraceName());
+
+  m_transmittedInterests(interest, this, m_face);
+  m_appLink->onReceiveInterest(*interest);
+}
+
+void
+KiteUploadServer::CheckSessionTimeouts()
+{
+  Time now = Simulator::Now();
+  bool running = false;
+
+  for (auto& item : m_sessions) {
+    UploadSession& session = item.second;
+    if (session.complete)
+      continue;
+
+    running = true;
+
+    Time rto = session.GetRto(m_tracingInterestLifeTime);
+    if (session.awaitingManifest) {
+      for (auto pending = session.manifestPending.begin(); pending != session.manifestPending.end();) {
+        if (pending->second + rto <= now)
+          pending = session.manifestPending.erase(pending);
+        else
+          ++pending;
+      }
+      FetchManifest(session);
+      continue;
+    }
+
+    for (auto pending = session.pending.begin(); pending != session.pending.end();) {
+      if (pending->second + rto <= now) {
+        NS_LOG_DEBUG("Segment " << pending->first << " of " << session.mobilePrefix << " timed out");
+        session.retxSeqs.insert(pending->first);
+        session.retransmitted.insert(pending->first);
+        ReleaseSegment(session, pending->first);
+        pending = session.pending.erase(pending);
+      }
+      else {
+        ++pending;
+      }
+    }
+  }
+  // missing segments are retried right away over the latest known trace
+  ScheduleSessions();
+
+  // the next bulk request restarts the check
+  if (running && m_active) {
+    m_sessionTimeoutEvent = Simulator::Schedule(m_retxTimer, &KiteUploadServer::CheckSessionTimeouts, this);
+  }
+}
+
+void
+KiteUploadServer::OnBulkData(UploadSession& session, shared_ptr<const Data> data)
+{
+  Name objectName;
+  uint32_t manifestSegment = 0;
+  if (KiteManifest::parseManifestName(data->getName(), objectName, manifestSegment)) {
+    if (objectName == session.mobilePrefix) {
+      OnManifest(session, manifestSegment, data);
+    }
+    return;
+  }
+
+  if (session.awaitingManifest || !data->getName().at(-1).isSequenceNumber())
+    return;
+
+  uint32_t seq = data->getName().at(-1).toSequenceNumber();
+
+  auto pending = session.pending.find(seq);
+  if (pending != session.pending.end()) {
+    if (session.retransmitted.count(seq) == 0) {
+      session.UpdateRtt(Simulator::Now() - pending->second);
+    }
+    ReleaseSegment(session, seq);
+    session.pending.erase(pending);
+  }
+  session.retxSeqs.erase(seq);
+
+  if (session.complete || seq >= session.objectSize || session.receivedSeqs[seq]) {
+    return; // duplicate
+  }
+
+  if (session.manifest != nullptr
+      && !session.manifest->verifySegment(seq, data->getContent().value(), data->getContent().value_size())) {
+    NS_LOG_WARN("Segment " << seq << " of " << session.mobilePrefix << " does not match the manifest");
+    session.retxSeqs.insert(seq);
+    session.retransmitted.insert(seq);
+    ScheduleSessions();
+    return;
+  }
+
+  session.receivedSeqs[seq] = true;
+  session.received++;
+  session.receivedBytes += data->getContent().value_size();
+  session.paths[session.segmentPaths[seq]].receivedBytes += data->getContent().value_size();
+
+  if (session.window < session.maxWindow && ++session.windowCredit >= session.window) {
+    session.window++;
+    session.windowCredit = 0;
+  }
+
+  if (session.received < session.objectSize) {
+    ScheduleSessions();
+    return;
+  }
+
+  session.complete = true;
+  session.finishTime = Simulator::Now();
+  Time completionTime = Simulator::Now() - session.startTime;
+  NS_LOG_INFO("node(" << GetNode()->GetId() << ") completed bulk upload from " << session.mobilePrefix
+              << ": " << session.objectSize << " segments, " << session.receivedBytes << " bytes in "
+              << completionTime.GetSeconds() << "s, goodput "
+              << (session.receivedBytes * 8 / completionTime.GetSeconds() / 1000) << " kbps");
+
+  m_uploadCompleted(session.mobilePrefix, session.objectSize, session.receivedBytes, completionTime);
+
+  for (const auto& path : session.paths) {
+    NS_LOG_INFO("Path " << path.first << ": " << path.second.receivedBytes << " bytes, goodput "
+                << (path.second.receivedBytes * 8 / completionTime.GetSeconds() / 1000) << " kbps");
+    m_pathCompleted(session.mobilePrefix, path.first, path.second.receivedBytes, completionTime);
+  }
+}
+
+void
+KiteUploadServer::ReleaseSegment(UploadSession& session, uint32_t seq)
+{
+  auto segmentPath = session.segmentPaths.find(seq);
+  if (segmentPath == session.segmentPaths.end())
+    return;
+
+  UploadPath& path = session.paths[segmentPath->second];
+  if (path.outstanding > 0) {
+    path.outstanding--;
+  }
+}
+
+void
+KiteUploadServer::OnNack(shared_ptr<const lp::Nack> nack)
+{
+  if (!m_serviceQueue->Enqueue(std::bind(&KiteUploadServer::ProcessNack, this, nack))) {
+    NS_LOG_INFO("node(" << GetNode()->GetId() << ") is overloaded, dropping Nack for " << nack->getInterest().getName());
+  }
+}
+
+void
+KiteUploadServer::ProcessNack(shared_ptr<const lp::Nack> nack)
+{
+  App::OnNack(nack); // tracing inside
+
+  const Name& name = nack->getInterest().getName();
+  NS_LOG_INFO("Server: receive Nack for " << name << ", reason: " << nack->getReason());
+
+  if (!m_active || name.empty())
+    return;
+
+  Name objectName;
+  uint32_t manifestSegment = 0;
+  if (KiteManifest::parseManifestName(name, objectName, manifestSegment)) {
+    auto item = m_sessions.find(objectName);
+    if (item == m_sessions.end())
+      return;
+
+    UploadSession& session = item->second;
+    if (!session.awaitingManifest || session.manifestPending.erase(manifestSegment) == 0)
+      return;
+
+    // manifest Interests follow the latest trace, FetchManifest() waits for the next one
+    for (auto& path : session.paths) {
+      if (path.second.traceName == session.traceName) {
+        path.second.broken = true;
+      }
+    }
+    session.window = std::max<uint32_t>(1, session.window / 2);
+    session.windowCredit = 0;
+    return;
+  }
+
+  if (!name.at(-1).isSequenceNumber())
+    return;
+
+  uint32_t seq = name.at(-1).toSequenceNumber();
+
+  auto item = m_sessions.find(name.getPrefix(-1));
+  if (item == m_sessions.end()) {
+    // stream mode, the next upload request picks the sequence up again
+    m_seqTimeouts.erase(seq);
+    m_retxSeqs.insert(seq);
+    return;
+  }
+
+  UploadSession& session = item->second;
+  auto pending = session.pending.find(seq);
+  if (session.complete || pending == session.pending.end())
+    return;
+
+  auto segmentPath = session.segmentPaths.find(seq);
+  if (segmentPath != session.segmentPaths.end()) {
+    session.paths[segmentPath->second].broken = true;
+  }
+
+  ReleaseSegment(session, seq);
+  session.pending.erase(pending);
+  session.retxSeqs.insert(seq);
+  session.retransmitted.insert(seq);
+
+  session.window = std::max<uint32_t>(1, session.window / 2);
+  session.windowCredit = 0;
+
+  // other paths may still hold a working trace
+  ScheduleSessions();
 }
 
 std::set<std::string> s;
@@ -192,8 +1175,38 @@ std::set<std::string> s;
 void 
 KiteUploadServer::OnData(shared_ptr<const Data> data)
 {
+  if (!m_serviceQueue->Enqueue(std::bind(&KiteUploadServer::ProcessData, this, data))) {
+    NS_LOG_INFO("node(" << GetNode()->GetId() << ") is overloaded, dropping Data " << data->getName());
+  }
+}
+
+void
+KiteUploadServer::ProcessData(shared_ptr<const Data> data)
+{
+  if (!m_active)
+    return;
+
   NS_LOG_INFO("Server: receive Data: " << data->getName());
-  
+
+  // manifest segments are named one component deeper than the segments of the object
+  Name mobilePrefix = data->getName().getPrefix(-1);
+  uint32_t manifestSegment = 0;
+  KiteManifest::parseManifestName(data->getName(), mobilePrefix, manifestSegment);
+
+  auto session = m_sessions.find(mobilePrefix);
+  if (session != m_sessions.end()) {
+    App::OnData(data); // tracing inside
+    OnBulkData(session->second, data);
+    return;
+  }
+
+  Consumer::OnData(data); // stream mode, clears the retransmission timer of the sequence
+
+  auto stream = m_streams.find(mobilePrefix);
+  if (stream != m_streams.end() && data->getName().at(-1).isSequenceNumber()) {
+    stream->second.outstanding.erase(data->getName().at(-1).toSequenceNumber());
+  }
+
   s.insert(data->getName().toUri());
   NS_LOG_INFO("CURRENT Data ammount: "<< data->getName().toUri() << ": " << s.size());
 }
@@ -24,6 +24,17 @@
 
 #include "ns3/ndnSIM/apps/ndn-consumer.hpp"
 
+#include "ns3/traced-callback.h"
+
+#include "kite-manifest.h"
+#include "kite-service-queue.h"
+
+#include <list>
+#include <map>
+#include <ostream>
+#include <set>
+#include <vector>
+
 namespace ns3 {
 namespace ndn {
 
@@ -32,9 +43,53 @@ namespace ndn {
  * @brief Ndn application that runs as the stationary server in upload scenarios supporting Kite scheme.
  * This one is a server application, it waits for Interest packets from mobile nodes that serve as upload requests,
  * It then sends out Interest towards the mobile node to pull the data it tries to upload.
- * Currently, the name of the uploading mobile node is fixed.
- * Eventually the upload request should include information about the mobile node,
- * and certain verification machanisms should be applied so that this won't be exploited to conduct DDoS attacks.
+ *
+ * Upload requests are named <ServerPrefix>/<MobilePrefix>[/bulk/<segments> | /manifest].
+ * Without the bulk marker, every upload request triggers one tracing Interest for the next sequence number
+ * under the MobilePrefix of the request (stream mode), or under Prefix for a request carrying no mobile prefix.
+ * With it, the server opens an upload session for the mobile and keeps up to Window tracing Interests
+ * outstanding until all segments are received, retransmitting the missing ones,
+ * and reports the completion time and goodput of the object through the UploadCompleted trace source.
+ * With the manifest marker, the server first fetches the segments of the object's KiteManifest, up to Window
+ * at a time once the first one tells how many there are, then sizes the window of the session from it
+ * (up to Window) and verifies every segment against the manifest digests.
+ *
+ * A mobile with several radios announces one upload request per path, <MobilePrefix>/path/<k> followed by the
+ * bulk or manifest marker, each setting up its own trace.  Bulk sessions spread their window over the paths
+ * announced within the last TracingInterestLifeTime, and report the bytes received over every path
+ * through the PathCompleted trace source.
+ *
+ * Every upload request is taken as a sign that the trace may have moved: with ReissueOnRefresh,
+ * tracing Interests for the same mobile sent before its previous request over the same path and not answered yet
+ * are re-sent along the fresh trace right away, instead of waiting for them to time out.
+ *
+ * A Nack for a tracing Interest means its trace is broken.  The segment, or manifest segment, is
+ * retransmitted right away once the mobile refreshes the trace with its next upload request, instead of
+ * waiting for the Interest to time out, and the window of the bulk session is halved; it grows back by
+ * one segment per window of received segments.
+ *
+ * With ShardCount set, the server is one of ShardCount instances sharing the upload load:
+ * it serves the prefix <ServerPrefix>/<ShardIndex> and only accepts mobiles whose prefix hashes to ShardIndex,
+ * see GetShard().
+ *
+ * Every upload request costs the server tracing Interests, so requests go through admission control first.
+ * With TokenSecret set, a request must carry /token/<MakeRequestToken()> after the path marker,
+ * which is checked before any state is kept for the mobile.  The token only binds the secret, the mobile
+ * prefix and the current TOKEN_WINDOW: it travels in clear, so whoever sees a request can replay it until
+ * the window after the next one starts, at no more than RequestRate per second for that mobile.
+ * With RequestRate set, every mobile prefix gets a token bucket of RequestBurst requests refilled
+ * at RequestRate per second, and requests beyond it are dropped.
+ * With MaxPending set, no new tracing Interest is sent while that many are outstanding over all mobiles.
+ * Every decision is reported through the RequestAdmission trace source.  Admission runs as soon as
+ * the request arrives, before the ServiceQueue, so rejected requests cost no service time or queue slot.
+ *
+ * Bulk sessions share the outstanding tracing Interests by deficit round-robin: whenever slots free up,
+ * every session in turn may send Weight segments (1 unless listed in Weights) within its own window,
+ * so that a mobile with a large window cannot starve the others under MaxPending.
+ * ReportFairness() writes the throughput of every session and Jain's index of the weighted throughputs.
+ *
+ * Interests, Data and Nacks are handled through the ServiceQueue of the server, which takes no time unless
+ * its Workers are set, see KiteServiceQueue.
  */
 class KiteUploadServer : public Consumer {
 public:
@@ -51,17 +106,292 @@ public:
   virtual void
   OnData(shared_ptr<const Data> data);
 
+  /**
+   * @brief Handle an Interest once the service queue gets to it
+   */
+  void
+  ProcessInterest(shared_ptr<const Interest> interest);
+
+  /**
+   * @brief Handle a Data once the service queue gets to it
+   */
+  void
+  ProcessData(shared_ptr<const Data> data);
+
+  virtual void
+  OnNack(shared_ptr<const lp::Nack> nack);
+
+  /**
+   * @brief A tracing Interest hit a broken trace: retransmit its segment over the next fresh trace,
+   * once the service queue gets to the Nack
+   */
+  void
+  ProcessNack(shared_ptr<const lp::Nack> nack);
+
   /**
    * @brief Actually send packet, with TraceFlag option
    */
   void
   SendInterest(shared_ptr<const Interest> tracedInterest, uint8_t traceFlag = 0);
 
+  /**
+   * @brief Send the stream mode tracing Interest for seq along the trace of the given upload request
+   */
+  void
+  SendStreamInterest(shared_ptr<const Interest> tracedInterest, uint32_t seq, uint8_t traceFlag);
+
+  /**
+   * @brief Shard serving uploads of the given mobile, FNV-1a hash of its prefix modulo shardCount
+   */
+  static uint32_t
+  GetShard(const Name& mobilePrefix, uint32_t shardCount);
+
+  /**
+   * @brief Request token of the given mobile at the given time, FNV-1a hash of the secret shared with
+   * the server, the index of the TOKEN_WINDOW holding time and the mobile prefix
+   */
+  static uint32_t
+  MakeRequestToken(const Name& mobilePrefix, uint32_t secret, Time time);
+
+  /**
+   * @brief Period a request token is valid for, the server also accepts tokens of the previous window
+   */
+  static const Time TOKEN_WINDOW;
+
+  /**
+   * @brief Jain's fairness index of the given allocations, 1 if they are all equal
+   */
+  static double
+  GetJainIndex(const std::vector<double>& values);
+
+  /**
+   * @brief Write the throughput of every bulk upload session, then Jain's index of the weighted throughputs
+   *
+   * Lines are <node>\t<mobile>\t<weight>\t<bytes>\t<kbps>, the last one <node>\tJain\t-\t-\t<index>.
+   * Throughput is measured up to the completion of the session, or up to now for sessions still running.
+   */
+  void
+  ReportFairness(std::ostream& os) const;
+
+  /**
+   * @brief Write every bulk upload completed by any server to the given file
+   *
+   * Lines are <time>\t<mobile>\t<segments>\t<bytes>\t<completion time>\t<goodput in kbps>, after a header line.
+   */
+  static void
+  TraceCompletions(const std::string& file);
+
+  typedef void (*UploadCompletedCallback)(const Name& mobilePrefix, uint32_t segments,
+                                          uint64_t bytes, Time completionTime);
+
+  typedef void (*PathCompletedCallback)(const Name& mobilePrefix, uint32_t path,
+                                        uint64_t bytes, Time completionTime);
+
+  typedef void (*RequestAdmissionCallback)(const Name& mobilePrefix, bool admitted);
+
 protected:
+  /**
+   * @brief Fields carried by the name of an upload request
+   */
+  struct UploadRequest
+  {
+    UploadRequest();
+
+    Name mobilePrefix;
+    uint32_t objectSize; ///< @brief number of segments announced in bulk mode, 0 otherwise
+    bool manifest;       ///< @brief object is described by a manifest
+    uint32_t path;       ///< @brief path the request was sent over, 0 for single-path mobiles
+    bool hasToken;
+    uint32_t token;      ///< @brief request token, see MakeRequestToken()
+  };
+
+  /**
+   * @brief Upload requests a mobile may still send without being rate limited
+   */
+  struct TokenBucket
+  {
+    TokenBucket();
+
+    double tokens;
+    Time lastRefill;
+    std::list<Name>::iterator position; ///< @brief in m_bucketOrder
+  };
+
+  /**
+   * @brief Stream mode state of one mobile
+   */
+  struct UploadStream
+  {
+    Time lastRequest;                     ///< @brief arrival of the previous upload request
+    std::map<uint32_t, Time> outstanding; ///< @brief unanswered sequence numbers and their last send time
+  };
+
+  /**
+   * @brief One trace of a multipath mobile
+   */
+  struct UploadPath
+  {
+    UploadPath();
+
+    Name traceName;        ///< @brief name of the latest upload request over this path
+    Time lastRequest;
+    uint32_t outstanding;
+    uint64_t receivedBytes;
+    bool broken;           ///< @brief a Nack came back since the latest upload request
+  };
+
+  /**
+   * @brief State of the bulk upload of one object from one mobile
+   */
+  struct UploadSession
+  {
+    UploadSession();
+
+    void
+    UpdateRtt(Time sample);
+
+    Time
+    GetRto(Time maxRto) const;
+
+    Name mobilePrefix;     ///< @brief segments are named <mobilePrefix>/<seq>
+    Name traceName;        ///< @brief name of the latest upload request over any path
+    uint32_t objectSize;
+    uint32_t window;
+    uint32_t maxWindow;
+    uint32_t windowCredit; ///< @brief segments received since the window last grew
+    uint32_t nextSeq;      ///< @brief next never requested segment
+    uint32_t received;
+    uint64_t receivedBytes;
+    Time startTime;
+    Time finishTime;
+    bool complete;
+
+    double weight;
+    double deficit;        ///< @brief segments the session may still send in the current round
+
+    std::set<uint32_t> retxSeqs;           ///< @brief segments to be retransmitted
+    std::map<uint32_t, Time> pending;      ///< @brief outstanding segments and their last send time
+    std::set<uint32_t> retransmitted;      ///< @brief segments sent more than once, not used for RTT samples
+    std::vector<bool> receivedSeqs;
+
+    std::map<uint32_t, UploadPath> paths;
+    std::map<uint32_t, uint32_t> segmentPaths; ///< @brief segment -> path of its latest request
+
+    bool awaitingManifest;
+    std::map<uint32_t, Time> manifestPending; ///< @brief outstanding manifest segments and their last send time
+    shared_ptr<KiteManifest> manifest;        ///< @brief digests received so far while awaitingManifest
+
+    Time srtt;
+    Time rttvar;
+  };
+
+  /**
+   * @brief Split an upload request name into its fields
+   * @returns false if the request does not carry a mobile prefix
+   */
+  bool
+  ParseUploadRequest(const Name& requestName, UploadRequest& request) const;
+
+  /**
+   * @brief Check the request token and the token bucket of the mobile, and count the decision
+   */
+  bool
+  AdmitRequest(const UploadRequest& request);
+
+  /**
+   * @brief Parse an upload request, drop it if it belongs to another shard, then admit it
+   * @returns false if the request is not served
+   */
+  bool
+  CheckUploadRequest(shared_ptr<const Interest> interest, UploadRequest& request);
+
+  /**
+   * @brief Tracing Interests outstanding over all sessions and the stream
+   */
+  uint32_t
+  GetPendingCount() const;
+
+  /**
+   * @brief Whether one more tracing Interest fits under MaxPending
+   */
+  bool
+  CanSendMore() const;
+
+  void
+  OnBulkRequest(shared_ptr<const Interest> tracedInterest, const UploadRequest& request);
+
+  /**
+   * @brief Request the manifest segments neither received nor outstanding, within the window of the session
+   */
+  void
+  FetchManifest(UploadSession& session);
+
+  void
+  SendManifestInterest(UploadSession& session, uint32_t manifestSegment);
+
+  void
+  OnManifest(UploadSession& session, uint32_t manifestSegment, shared_ptr<const Data> data);
+
+  /**
+   * @brief Hand out free slots to the sessions by deficit round-robin until no session can send more
+   */
+  void
+  ScheduleSessions();
+
+  /**
+   * @brief Whether the session has a segment to request, room in its window and a path to send it over
+   */
+  bool
+  CanSendSegment(const UploadSession& session) const;
+
+  /**
+   * @brief Send the tracing Interest for the next missing segment of the session
+   * @returns false if the session cannot send, see CanSendSegment()
+   */
+  bool
+  SendNextSegment(UploadSession& session);
+
+  void
+  SetWeights(const std::string& value);
+
+  std::string
+  GetWeights() const;
+
+  /**
+   * @brief Path with the fewest outstanding segments among the paths with a fresh trace
+   * @returns an invalid path if the traces of all paths are broken
+   */
+  uint32_t
+  SelectPath(const UploadSession& session) const;
+
+  void
+  SendTracingInterest(UploadSession& session, uint32_t seq, uint32_t pathId);
+
+  /**
+   * @brief Re-send the segments sent over the given path up to since and still outstanding
+   */
+  void
+  ReissueOutstanding(UploadSession& session, uint32_t pathId, Time since);
+
+  /**
+   * @brief Account for a segment request that is no longer outstanding
+   */
+  void
+  ReleaseSegment(UploadSession& session, uint32_t seq);
+
+  void
+  OnBulkData(UploadSession& session, shared_ptr<const Data> data);
+
+  void
+  CheckSessionTimeouts();
+
   // from App
   virtual void
   StartApplication();
 
+  virtual void
+  StopApplication();
+
   /**
    * \brief Actually does nothing.
    */
@@ -71,7 +401,39 @@ protected:
 protected:
   // m_interestName inherited from Consumer
   Name m_serverPrefix;
+  Name m_servedPrefix; ///< @brief ServerPrefix, followed by ShardIndex if the server is sharded
   Time m_tracingInterestLifeTime;
+  uint32_t m_window; ///< @brief outstanding tracing Interests per bulk upload session (upper bound with manifests)
+  bool m_reissueOnRefresh;
+  uint32_t m_shardCount; ///< @brief 0 if the server is not sharded
+  uint32_t m_shardIndex;
+
+  double m_requestRate;    ///< @brief upload requests per second allowed per mobile, 0 if not limited
+  uint32_t m_requestBurst;
+  uint32_t m_maxPending;   ///< @brief outstanding tracing Interests over all mobiles, 0 if not limited
+  uint32_t m_tokenSecret;  ///< @brief 0 if requests need no token
+  /**
+   * @brief Token buckets kept at most, beyond it the least recently used one is dropped
+   */
+  static const size_t MAX_BUCKETS;
+
+  std::map<Name, TokenBucket> m_buckets; ///< @brief by mobile prefix
+  std::list<Name> m_bucketOrder;         ///< @brief mobile prefixes of m_buckets, least recently used first
+  uint64_t m_admittedRequests;
+  uint64_t m_rejectedRequests;
+
+  std::map<Name, UploadStream> m_streams;   ///< @brief stream mode uploads, by mobile prefix
+  std::map<Name, UploadSession> m_sessions; ///< @brief bulk upload sessions, by mobile prefix
+  Name m_lastScheduled; ///< @brief session that got the latest slot, the next round starts after it
+  std::string m_weightsString;
+  std::map<Name, double> m_weights;
+  EventId m_sessionTimeoutEvent;
+
+  TracedCallback<const Name&, uint32_t, uint64_t, Time> m_uploadCompleted;
+  TracedCallback<const Name&, uint32_t, uint64_t, Time> m_pathCompleted;
+  TracedCallback<const Name&, bool> m_requestAdmission;
+
+  Ptr<KiteServiceQueue> m_serviceQueue;
 };
 
 } // namespace ndn
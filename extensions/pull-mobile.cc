@@ -18,12 +18,14 @@
  **/
 
 #include "pull-mobile.h"
+#include "pull-server.h"
 #include "ns3/log.h"
 #include "ns3/string.h"
 #include "ns3/boolean.h"
 #include "ns3/uinteger.h"
 #include "ns3/integer.h"
 #include "ns3/double.h"
+#include "ns3/pointer.h"
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 
@@ -61,6 +63,21 @@ KitePullMobile::GetTypeId(void)
                     MakeNameAccessor(&KitePullMobile::m_serverPrefix), MakeNameChecker())
       .AddAttribute("InterestLifeTime", "LifeTime for traced Interest packet", StringValue("2s"),
                     MakeTimeAccessor(&KitePullMobile::m_interestLifeTime), MakeTimeChecker())
+
+      .AddAttribute("AnchorPrefixes",
+                    "Whitespace separated prefixes of candidate anchors, overrides AnchorPrefix if not empty",
+                    StringValue(""),
+                    MakeStringAccessor(&KitePullMobile::SetAnchorPrefixes, &KitePullMobile::GetAnchorPrefixes),
+                    MakeStringChecker())
+      .AddAttribute("ProbeInterval", "Interval between two RTT probes of the candidate anchors", StringValue("500ms"),
+                    MakeTimeAccessor(&KitePullMobile::m_probeInterval), MakeTimeChecker())
+      .AddAttribute("AnnounceTraces", "Tell the server about every trace sent, so that it can re-send what is pending",
+                    BooleanValue(false),
+                    MakeBooleanAccessor(&KitePullMobile::m_announceTraces), MakeBooleanChecker())
+      .AddAttribute("HandoffPredictor", "Predictor of the entries into the range of the next access point",
+                    TypeId::ATTR_GET, PointerValue(),
+                    MakePointerAccessor(&KitePullMobile::m_predictor),
+                    MakePointerChecker<KiteHandoffPredictor>())
     ;
   return tid;
 }
@@ -68,6 +85,10 @@ KitePullMobile::GetTypeId(void)
 KitePullMobile::KitePullMobile()
   : m_rand(CreateObject<UniformRandomVariable>())
   , m_seq(0) 
+  , m_anchorUpdateSeq(0)
+  , m_anchorUpdatePending(false)
+  , m_announceTraces(false)
+  , m_predictor(CreateObject<KiteHandoffPredictor>())
 {
   NS_LOG_FUNCTION_NOARGS();
 }
@@ -78,7 +99,17 @@ KitePullMobile::StartApplication()
 {
   NS_LOG_FUNCTION_NOARGS();
   Producer::StartApplication();
-  
+
+  if (m_anchors.GetAnchorCount() > 0) {
+    NameValue prefix;
+    GetAttribute("Prefix", prefix);
+    m_mobilePrefix = prefix.Get();
+
+    ProbeAnchors();
+  }
+
+  m_predictor->Start(GetNode(), MakeCallback(&KitePullMobile::SendTrace, this));
+
   SendTrace();
 }
 
@@ -87,6 +118,10 @@ KitePullMobile::StopApplication()
 {
   NS_LOG_FUNCTION_NOARGS();
 
+  m_predictor->Stop();
+  Simulator::Cancel(m_probeEvent);
+  Simulator::Cancel(m_traceEvent);
+
   App::StopApplication();
 }
 
@@ -96,8 +131,28 @@ KitePullMobile::SendTrace()
 
   NS_LOG_FUNCTION_NOARGS();
 
+  if (!m_active)
+    return;
+
+  // Send out trace at intervals equal to lifetime of trace
+  Simulator::Cancel(m_traceEvent);
+  m_traceEvent = Simulator::Schedule(Seconds(2.1), &KitePullMobile::SendTrace, this);
+
   // periodly send traced Interest with anchor prefix to set up a from-anchor-to-mobile trace.
   shared_ptr<Name> name = make_shared<Name>(m_anchorPrefix); 
+  if (m_anchors.GetAnchorCount() > 0) {
+    if (!m_anchors.HasSelection()) {
+      NS_LOG_DEBUG("No anchor reachable yet");
+      return;
+    }
+
+    name = make_shared<Name>(m_anchors.GetSelectedAnchor());
+    name->append(m_mobilePrefix);
+
+    if (m_anchorUpdatePending) {
+      SendAnchorUpdate();
+    }
+  }
 
   shared_ptr<Interest> interest = make_shared<Interest>();
   interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
@@ -108,16 +163,28 @@ KitePullMobile::SendTrace()
 
   NS_LOG_INFO("> Traced Interest Name: " << name->toUri() << ", sent to Face: " << *m_face);
 
-  Simulator::Schedule(Seconds(2.1), &KitePullMobile::SendTrace, this); // Send out trace at intervals equal to lifetime of trace
-
   m_transmittedInterests(interest, this, m_face);
   m_appLink->onReceiveInterest(*interest);
   //Send upload request.
+
+  if (m_announceTraces) {
+    shared_ptr<Interest> refresh = make_shared<Interest>();
+    refresh->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+    refresh->setName(KitePullServer::MakeTraceRefreshName(m_serverPrefix, m_seq++));
+    refresh->setInterestLifetime(interestLifeTime);
+
+    NS_LOG_INFO("> Trace refresh: " << refresh->getName());
+
+    m_transmittedInterests(refresh, this, m_face);
+    m_appLink->onReceiveInterest(*refresh);
+  }
 }
 
 void
 KitePullMobile::OnInterest(shared_ptr<const Interest> interest)
 {
+  App::OnInterest(interest); // tracing inside
+
   if (interest->hasTraceName()) {
     NS_LOG_INFO("Mobile: Receive tracing Interest: " << interest->getName() << ", TraceName: " << interest->getTraceName());
   }
@@ -128,6 +195,83 @@ KitePullMobile::OnInterest(shared_ptr<const Interest> interest)
   // Producer::OnInterest(interest);
 }
 
+void
+KitePullMobile::OnData(shared_ptr<const Data> data)
+{
+  App::OnData(data); // tracing inside
+
+  Name anchor;
+  Name traceName;
+  if (m_anchors.OnProbeData(data->getName())) {
+    NS_LOG_DEBUG("Mobile: probe answered: " << data->getName());
+  }
+  else if (KiteAnchorSelector::ParseAnchorUpdate(data->getName(), m_serverPrefix, anchor, traceName)
+           && m_anchors.HasSelection() && anchor == m_anchors.GetSelectedAnchor()) {
+    NS_LOG_INFO("Mobile: server now reaches us through " << anchor);
+    m_anchorUpdatePending = false;
+  }
+}
+
+void
+KitePullMobile::ProbeAnchors()
+{
+  if (!m_active)
+    return;
+
+  // probes still unanswered after one interval count as lost
+  m_anchors.ExpireProbes(m_probeInterval);
+
+  if (m_anchors.Reselect()) {
+    m_anchorUpdatePending = true;
+    SendTrace(); // set up the trace through the new anchor right away
+  }
+
+  for (size_t i = 0; i < m_anchors.GetAnchorCount(); i++) {
+    shared_ptr<Interest> interest = make_shared<Interest>();
+    interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+    interest->setName(m_anchors.MakeProbeName(i));
+    time::milliseconds interestLifeTime(m_probeInterval.GetMilliSeconds());
+    interest->setInterestLifetime(interestLifeTime);
+
+    m_transmittedInterests(interest, this, m_face);
+    m_appLink->onReceiveInterest(*interest);
+  }
+
+  m_probeEvent = Simulator::Schedule(m_probeInterval, &KitePullMobile::ProbeAnchors, this);
+}
+
+void
+KitePullMobile::SendAnchorUpdate()
+{
+  Name traceName(m_anchors.GetSelectedAnchor());
+  traceName.append(m_mobilePrefix);
+
+  shared_ptr<Interest> interest = make_shared<Interest>();
+  interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+  interest->setName(KiteAnchorSelector::MakeAnchorUpdateName(m_serverPrefix, m_anchors.GetSelectedAnchor(),
+                                                             traceName, m_anchorUpdateSeq++));
+  time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
+  interest->setInterestLifetime(interestLifeTime);
+
+  NS_LOG_INFO("> Anchor update: " << interest->getName());
+
+  m_transmittedInterests(interest, this, m_face);
+  m_appLink->onReceiveInterest(*interest);
+}
+
+void
+KitePullMobile::SetAnchorPrefixes(const std::string& value)
+{
+  m_anchors.SetAnchors(value);
+  m_anchorPrefixes = value;
+}
+
+std::string
+KitePullMobile::GetAnchorPrefixes() const
+{
+  return m_anchorPrefixes;
+}
+
 void
 KitePullMobile::SetRandomize(const std::string& value)
 {
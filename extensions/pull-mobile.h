@@ -28,6 +28,10 @@
 
 #include "ns3/ndnSIM/apps/ndn-producer.hpp"
 
+#include "kite-handoff-predictor.h"
+
+#include "kite-anchor-selector.h"
+
 namespace ns3 {
 namespace ndn {
 
@@ -40,6 +44,16 @@ namespace ndn {
  * In pull scenario, this should run on a mobile node, 
  * and the trace will be set up through an anchor,
  * which is a normal forwarding node that states a special prefix in the topology.
+ *
+ * With AnchorPrefixes set, the mobile probes every listed anchor each ProbeInterval,
+ * attaches its trace <anchor>/<Prefix> to the anchor with the lowest RTT,
+ * and tells the server about every change of anchor with an anchor update.
+ *
+ * With AnnounceTraces set, every traced Interest is followed by a trace refresh to the server,
+ * see KitePullServer.
+ *
+ * With access points set on its HandoffPredictor, the mobile sends an extra traced Interest at the moment
+ * it is expected to come within range of the next access point, see KiteHandoffPredictor.
  */
 class KitePullMobile : public Producer {
 public:
@@ -54,6 +68,9 @@ public:
   virtual void
   OnInterest(shared_ptr<const Interest> interest);
 
+  virtual void
+  OnData(shared_ptr<const Data> data);
+
 protected:
   // inherited from Application base class.
   virtual void
@@ -76,6 +93,21 @@ protected:
   std::string
   GetRandomize() const;
 
+  /**
+   * @brief Probe all anchors and move the trace if a closer one has been found
+   */
+  void
+  ProbeAnchors();
+
+  void
+  SendAnchorUpdate();
+
+  void
+  SetAnchorPrefixes(const std::string& value);
+
+  std::string
+  GetAnchorPrefixes() const;
+
 private:
   Name m_anchorPrefix;
   Name m_serverPrefix;
@@ -86,6 +118,18 @@ private:
   std::string m_randomType;
   
   int m_seq;
+
+  std::string m_anchorPrefixes;
+  KiteAnchorSelector m_anchors;
+  Time m_probeInterval;
+  EventId m_probeEvent;
+  Name m_mobilePrefix;          ///< @brief Prefix of the Producer, appended to the selected anchor
+  uint32_t m_anchorUpdateSeq;
+  bool m_anchorUpdatePending;   ///< @brief the server has not acknowledged the current anchor yet
+  EventId m_traceEvent;
+  bool m_announceTraces;
+
+  Ptr<KiteHandoffPredictor> m_predictor;
 };
 
 } // namespace ndn
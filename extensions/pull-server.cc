@@ -31,6 +31,10 @@
 
 #include "helper/ndn-fib-helper.hpp"
 
+#include "kite-anchor-selector.h"
+
+#include <vector>
+
 NS_LOG_COMPONENT_DEFINE("ndn.kite.KitePullServer");
 
 namespace ns3 {
@@ -60,12 +64,23 @@ KitePullServer::GetTypeId(void)
                     IntegerValue(std::numeric_limits<uint32_t>::max()),
                     MakeIntegerAccessor(&KitePullServer::m_seqMax), MakeIntegerChecker<uint32_t>())
 
+      .AddAttribute("ReissueOnRefresh",
+                    "Re-send outstanding tracing Interests whenever the mobile announces a refreshed trace",
+                    BooleanValue(true),
+                    MakeBooleanAccessor(&KitePullServer::m_reissueOnRefresh), MakeBooleanChecker())
+
+      .AddAttribute("FollowAnchor", "Send tracing Interests through the anchor announced by the mobile",
+                    BooleanValue(false),
+                    MakeBooleanAccessor(&KitePullServer::m_followAnchor), MakeBooleanChecker())
+
     ;
 
   return tid;
 }
 
 KitePullServer::KitePullServer()
+  : m_reissueOnRefresh(true)
+  , m_followAnchor(false)
 {
   NS_LOG_FUNCTION_NOARGS();
   m_seq = 0;
@@ -93,6 +108,12 @@ KitePullServer::SendInterest()
 
   NS_LOG_FUNCTION_NOARGS();
 
+  if (m_followAnchor && m_anchor.empty()) {
+    NS_LOG_DEBUG("Server: no anchor announced yet");
+    m_sendEvent = Simulator::Schedule(Seconds(5), &KitePullServer::SendInterest, this);
+    return;
+  }
+
   uint32_t seq = std::numeric_limits<uint32_t>::max(); // invalid
 
   while (m_retxSeqs.size()) {
@@ -111,7 +132,17 @@ KitePullServer::SendInterest()
     seq = m_seq++;
   }
 
-  shared_ptr<Name> nameWithSequence = make_shared<Name>(m_interestName);
+  SendTracingInterest(seq);
+
+  Simulator::Cancel(m_sendEvent);
+  m_sendEvent = Simulator::Schedule(Seconds(5), &KitePullServer::SendInterest, this);
+}
+
+void
+KitePullServer::SendTracingInterest(uint32_t seq)
+{
+  shared_ptr<Name> nameWithSequence = make_shared<Name>(m_followAnchor ? m_anchor : Name());
+  nameWithSequence->append(m_interestName);
   nameWithSequence->appendSequenceNumber(seq);
 
   shared_ptr<Interest> interest = make_shared<Interest>();
@@ -130,14 +161,139 @@ KitePullServer::SendInterest()
 
   m_transmittedInterests(interest, this, m_face);
   m_appLink->onReceiveInterest(*interest);
+}
+
+void
+KitePullServer::ReissueOutstanding()
+{
+  if (m_followAnchor && m_anchor.empty())
+    return;
+
+  std::vector<uint32_t> stale;
+  for (const auto& timeout : m_seqTimeouts) {
+    stale.push_back(timeout.seq);
+  }
+
+  for (uint32_t seq : stale) {
+    NS_LOG_DEBUG("Server: reissuing " << seq << " over the refreshed trace");
+    m_seqTimeouts.erase(seq); // restart its retransmission timer, Data of either copy satisfies it
+    SendTracingInterest(seq);
+  }
+}
+
+void
+KitePullServer::RetryMissing()
+{
+  if (m_followAnchor && m_anchor.empty())
+    return;
+
+  while (!m_retxSeqs.empty()) {
+    uint32_t seq = *m_retxSeqs.begin();
+    m_retxSeqs.erase(m_retxSeqs.begin());
+
+    NS_LOG_DEBUG("Server: retrying " << seq << " over the refreshed trace");
+    SendTracingInterest(seq);
+  }
+}
+
+Name
+KitePullServer::MakeTraceRefreshName(const Name& serverPrefix, uint32_t seq)
+{
+  Name refreshName(serverPrefix);
+  refreshName.append("kite-trace").appendSequenceNumber(seq);
+  return refreshName;
+}
+
+bool
+KitePullServer::IsTraceRefresh(const Name& name, const Name& serverPrefix)
+{
+  return name.size() == serverPrefix.size() + 2 && serverPrefix.isPrefixOf(name)
+         && name.get(-2) == ::ndn::name::Component("kite-trace") && name.get(-1).isSequenceNumber();
+}
+
+void
+KitePullServer::SendAck(shared_ptr<const Interest> interest)
+{
+  auto data = make_shared<Data>();
+  data->setName(interest->getName());
+  data->setFreshnessPeriod(::ndn::time::milliseconds(0));
 
-  Simulator::Schedule(Seconds(5), &KitePullServer::SendInterest, this);
+  Signature signature;
+  SignatureInfo signatureInfo(static_cast< ::ndn::tlv::SignatureTypeValue>(255));
+  signature.setInfo(signatureInfo);
+  signature.setValue(::ndn::makeNonNegativeIntegerBlock(::ndn::tlv::SignatureValue, 0));
+  data->setSignature(signature);
+
+  data->wireEncode();
+
+  m_transmittedDatas(data, this, m_face);
+  m_appLink->onReceiveData(*data);
+}
+
+void
+KitePullServer::OnInterest(shared_ptr<const Interest> interest)
+{
+  App::OnInterest(interest); // tracing inside
+
+  if (!m_active)
+    return;
+
+  if (IsTraceRefresh(interest->getName(), m_serverPrefix)) {
+    NS_LOG_INFO("Server: mobile refreshed its trace: " << interest->getName());
+    if (m_reissueOnRefresh) {
+      ReissueOutstanding();
+    }
+    RetryMissing();
+    SendAck(interest);
+    return;
+  }
+
+  Name anchor;
+  Name traceName;
+  if (!KiteAnchorSelector::ParseAnchorUpdate(interest->getName(), m_serverPrefix, anchor, traceName)) {
+    NS_LOG_INFO("Server: receive Interest: " << interest->getName());
+    return;
+  }
+
+  bool moved = anchor != m_anchor;
+  if (moved) {
+    NS_LOG_INFO("Server: mobile moved its trace " << traceName << " to anchor " << anchor);
+  }
+  m_anchor = anchor;
+  m_traceNamePrefix = traceName;
+
+  if (moved && m_reissueOnRefresh) {
+    ReissueOutstanding();
+  }
+  RetryMissing();
+
+  // acknowledge, so that the mobile stops repeating the update
+  SendAck(interest);
 }
 
 void 
 KitePullServer::OnData(shared_ptr<const Data> data)
 {
   NS_LOG_INFO("Server: receive Data: " << data->getName());
+
+  Consumer::OnData(data); // clears the retransmission timer of the sequence
+}
+
+void
+KitePullServer::OnNack(shared_ptr<const lp::Nack> nack)
+{
+  App::OnNack(nack); // tracing inside
+
+  const Name& name = nack->getInterest().getName();
+  NS_LOG_INFO("Server: receive Nack for " << name << ", reason: " << nack->getReason());
+
+  if (!m_active || name.empty() || !name.at(-1).isSequenceNumber())
+    return;
+
+  // the next trace refresh or anchor update retries it, see RetryMissing()
+  uint32_t seq = name.at(-1).toSequenceNumber();
+  m_seqTimeouts.erase(seq);
+  m_retxSeqs.insert(seq);
 }
 
 } // namespace ndn
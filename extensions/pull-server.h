@@ -35,6 +35,16 @@ namespace ndn {
  * Currently, the name of the uploading mobile node is fixed.
  * Eventually the upload request should include information about the mobile node,
  * and certain verification machanisms should be applied so that this won't be exploited to conduct DDoS attacks.
+ *
+ * With FollowAnchor set, Prefix is relative to the anchor currently holding the mobile's trace:
+ * tracing Interests are named <anchor>/<Prefix>/<seq> and carry the trace name of the last anchor update.
+ *
+ * A mobile may announce every trace it sends with a trace refresh named <ServerPrefix>/kite-trace/<seq>.
+ * With ReissueOnRefresh, every refresh or change of anchor re-sends all outstanding tracing Interests
+ * along the fresh trace, instead of waiting for them to time out.
+ *
+ * A Nack for a tracing Interest means the trace is broken: the sequence is retried as soon as the mobile
+ * refreshes its trace or moves it to another anchor, or in the next round if it announces neither.
  */
 class KitePullServer : public Consumer {
 public:
@@ -44,15 +54,30 @@ public:
   KitePullServer();
   virtual ~KitePullServer() {};
 
+  virtual void
+  OnInterest(shared_ptr<const Interest> interest);
+
   virtual void
   OnData(shared_ptr<const Data> data);
 
+  virtual void
+  OnNack(shared_ptr<const lp::Nack> nack);
+
   /**
    * @brief Actually send packet, with TraceFlag option
    */
   void
   SendInterest();
 
+  /**
+   * @brief Name of a trace refresh sent by a mobile
+   */
+  static Name
+  MakeTraceRefreshName(const Name& serverPrefix, uint32_t seq);
+
+  static bool
+  IsTraceRefresh(const Name& name, const Name& serverPrefix);
+
 protected:
   // from App
   virtual void
@@ -64,11 +89,35 @@ protected:
   virtual void
   ScheduleNextPacket() {};
 
+  void
+  SendTracingInterest(uint32_t seq);
+
+  /**
+   * @brief Re-send all outstanding tracing Interests along the current trace
+   */
+  void
+  ReissueOutstanding();
+
+  /**
+   * @brief Send the sequences waiting for retransmission, e.g. after a Nack, along the current trace
+   */
+  void
+  RetryMissing();
+
+  void
+  SendAck(shared_ptr<const Interest> interest);
+
 protected:
   // m_interestName inherited from Consumer
   Name m_traceNamePrefix;
   Name m_serverPrefix;
   Time m_tracingInterestLifeTime;
+
+  EventId m_sendEvent;
+  bool m_reissueOnRefresh;
+
+  bool m_followAnchor;
+  Name m_anchor; ///< @brief anchor of the last anchor update, empty if none was received
 };
 
 } // namespace ndn
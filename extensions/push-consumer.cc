@@ -18,6 +18,7 @@
  **/
 
 #include "push-consumer.h"
+#include "push-producer.h"
 #include "ns3/log.h"
 #include "ns3/string.h"
 #include "ns3/boolean.h"
@@ -32,6 +33,7 @@
 
 #include <memory>
 #include <ctime>
+#include <cstring>
 
 NS_LOG_COMPONENT_DEFINE("ndn.kite.KitePushConsumer");
 
@@ -62,11 +64,38 @@ KitePushConsumer::GetTypeId(void)
       .AddAttribute("MaxSeq", "Maximum sequence number to request",
                     IntegerValue(std::numeric_limits<uint32_t>::max()),
                     MakeIntegerAccessor(&KitePushConsumer::m_seqMax), MakeIntegerChecker<uint32_t>())
+
+      .AddAttribute("Window", "Number of outstanding fetch Interests when catching up with the backlog",
+                    UintegerValue(4),
+                    MakeUintegerAccessor(&KitePushConsumer::m_window), MakeUintegerChecker<uint32_t>(1))
+      .AddAttribute("BatchSize", "Number of consecutive messages requested by one fetch Interest",
+                    UintegerValue(1),
+                    MakeUintegerAccessor(&KitePushConsumer::m_batchSize), MakeUintegerChecker<uint32_t>(1))
+
+      .AddAttribute("AnchorPrefixes",
+                    "Whitespace separated prefixes of candidate anchors, overrides AnchorPrefix if not empty",
+                    StringValue(""),
+                    MakeStringAccessor(&KitePushConsumer::SetAnchorPrefixes, &KitePushConsumer::GetAnchorPrefixes),
+                    MakeStringChecker())
+      .AddAttribute("ProbeInterval", "Interval between two RTT probes of the candidate anchors", StringValue("500ms"),
+                    MakeTimeAccessor(&KitePushConsumer::m_probeInterval), MakeTimeChecker())
+
+      .AddTraceSource("MessageDelivered", "A pushed message has been delivered",
+                      MakeTraceSourceAccessor(&KitePushConsumer::m_messageDelivered),
+                      "ns3::ndn::KitePushConsumer::MessageDeliveredCallback")
     ;
   return tid;
 }
 
 KitePushConsumer::KitePushConsumer()
+  : m_window(4)
+  , m_cwnd(4)
+  , m_cwndCredit(0)
+  , m_batchSize(1)
+  , m_backlogMode(false)
+  , m_highestAvailable(0)
+  , m_anchorUpdateSeq(0)
+  , m_anchorUpdatePending(false)
 {
   NS_LOG_FUNCTION_NOARGS();
   m_seq = 0;
@@ -81,7 +110,13 @@ KitePushConsumer::StartApplication()
   App::StartApplication();
 
   FibHelper::AddRoute(GetNode(), m_serverPrefix, m_face, 0);
-  
+
+  m_cwnd = m_window;
+
+  if (m_anchors.GetAnchorCount() > 0) {
+    ProbeAnchors();
+  }
+
   SendTrace();
 }
 
@@ -90,6 +125,9 @@ KitePushConsumer::StopApplication()
 {
   NS_LOG_FUNCTION_NOARGS();
 
+  Simulator::Cancel(m_probeEvent);
+  Simulator::Cancel(m_traceEvent);
+
   App::StopApplication();
 }
 
@@ -99,8 +137,28 @@ KitePushConsumer::SendTrace()
 
   NS_LOG_FUNCTION_NOARGS();
 
+  if (!m_active)
+    return;
+
+  // Send out trace at intervals equal to lifetime of trace
+  Simulator::Cancel(m_traceEvent);
+  m_traceEvent = Simulator::Schedule(Seconds(1.9), &KitePushConsumer::SendTrace, this);
+
   // periodly send traced Interest with anchor prefix to set up a from-anchor-to-mobile trace.
   shared_ptr<Name> name = make_shared<Name>(m_anchorPrefix); 
+  if (m_anchors.GetAnchorCount() > 0) {
+    if (!m_anchors.HasSelection()) {
+      NS_LOG_DEBUG("No anchor reachable yet");
+      return;
+    }
+
+    name = make_shared<Name>(m_anchors.GetSelectedAnchor());
+    name->append(m_interestName);
+
+    if (m_anchorUpdatePending) {
+      SendAnchorUpdate();
+    }
+  }
 
   shared_ptr<Interest> interest = make_shared<Interest>();
   interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
@@ -111,8 +169,6 @@ KitePushConsumer::SendTrace()
 
   NS_LOG_INFO("> Traced Interest Name: " << name->toUri() << ", sent to Face: " << *m_face);
 
-  Simulator::Schedule(Seconds(1.9), &KitePushConsumer::SendTrace, this); // Send out trace at intervals equal to lifetime of trace
-
   m_transmittedInterests(interest, this, m_face);
   m_appLink->onReceiveInterest(*interest);
   //Send upload request.
@@ -121,7 +177,21 @@ KitePushConsumer::SendTrace()
 void
 KitePushConsumer::OnInterest(shared_ptr<const Interest> interest)
 {
-  if (interest->hasTraceName()) {
+  App::OnInterest(interest); // tracing inside
+
+  if (interest->hasTraceName() && !interest->getName().empty()
+      && interest->getName().at(-1).isSequenceNumber()) {
+    NS_LOG_INFO("Mobile: Receive notification: " << interest->getName() << ", TraceName: " << interest->getTraceName());
+
+    uint32_t highest = interest->getName().at(-1).toSequenceNumber();
+    if (!m_backlogMode || highest > m_highestAvailable) {
+      m_highestAvailable = highest;
+    }
+    m_backlogMode = true;
+
+    FetchBacklog();
+  }
+  else if (interest->hasTraceName()) {
     NS_LOG_INFO("Mobile: Receive tracing Interest: " << interest->getName() << ", TraceName: " << interest->getTraceName());
 
     uint32_t seq = std::numeric_limits<uint32_t>::max(); // invalid
@@ -164,5 +234,212 @@ KitePushConsumer::OnInterest(shared_ptr<const Interest> interest)
   }
 }
 
+void
+KitePushConsumer::ScheduleNextPacket()
+{
+  if (m_backlogMode) {
+    FetchBacklog();
+  }
+}
+
+void
+KitePushConsumer::FetchBacklog()
+{
+  if (!m_active)
+    return;
+
+  while (m_seqTimeouts.size() < m_cwnd) {
+    uint32_t seq = std::numeric_limits<uint32_t>::max(); // invalid
+    uint32_t count = 1;
+
+    if (!m_retxSeqs.empty()) {
+      seq = *m_retxSeqs.begin();
+      m_retxSeqs.erase(m_retxSeqs.begin());
+
+      auto batch = m_batches.find(seq);
+      if (batch != m_batches.end()) {
+        count = batch->second;
+      }
+    }
+    else if (m_seq <= m_highestAvailable && m_seq < m_seqMax) {
+      seq = m_seq;
+      count = std::min(m_batchSize, m_highestAvailable - m_seq + 1);
+      m_seq += count;
+    }
+    else {
+      break; // caught up
+    }
+
+    m_batches[seq] = count;
+    SendFetchInterest(seq, count);
+  }
+}
+
+void
+KitePushConsumer::SendFetchInterest(uint32_t seq, uint32_t count)
+{
+  shared_ptr<Name> nameWithSequence = make_shared<Name>(m_serverPrefix);
+  if (count > 1) {
+    nameWithSequence->append("batch").appendNumber(count);
+  }
+  nameWithSequence->appendSequenceNumber(seq);
+
+  shared_ptr<Interest> interest = make_shared<Interest>();
+  interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+  interest->setName(*nameWithSequence);
+  time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
+  interest->setInterestLifetime(interestLifeTime);
+
+  NS_LOG_INFO("> Fetch Interest for " << count << " messages from " << seq << ", Name: " << interest->getName());
+
+  WillSendOutInterest(seq);
+
+  m_transmittedInterests(interest, this, m_face);
+  m_appLink->onReceiveInterest(*interest);
+}
+
+void
+KitePushConsumer::OnData(shared_ptr<const Data> data)
+{
+  if (!m_active)
+    return;
+
+  Name anchor;
+  Name traceName;
+  if (m_anchors.OnProbeData(data->getName())) {
+    App::OnData(data); // not a fetched message, keep the retransmission state out of it
+    return;
+  }
+  if (KiteAnchorSelector::ParseAnchorUpdate(data->getName(), m_serverPrefix, anchor, traceName)) {
+    App::OnData(data);
+    if (m_anchors.HasSelection() && anchor == m_anchors.GetSelectedAnchor()) {
+      NS_LOG_INFO("Mobile: producer now reaches us through " << anchor);
+      m_anchorUpdatePending = false;
+    }
+    return;
+  }
+
+  Consumer::OnData(data); // tracing and retransmission timers inside
+
+  if (m_cwnd < m_window && ++m_cwndCredit >= m_cwnd) {
+    m_cwnd++;
+    m_cwndCredit = 0;
+  }
+
+  if (!m_backlogMode)
+    return;
+
+  m_batches.erase(data->getName().at(-1).toSequenceNumber());
+
+  const Block& content = data->getContent();
+  const uint8_t* position = content.value();
+  const uint8_t* end = content.value() + content.value_size();
+
+  uint32_t messageCount = 0;
+  if (position + sizeof(messageCount) <= end) {
+    std::memcpy(&messageCount, position, sizeof(messageCount));
+    position += sizeof(messageCount);
+  }
+
+  for (uint32_t i = 0; i < messageCount && position + KitePushProducer::MESSAGE_HEADER_SIZE <= end; i++) {
+    uint32_t seq = 0;
+    uint64_t published = 0;
+    std::memcpy(&seq, position, sizeof(seq));
+    std::memcpy(&published, position + sizeof(seq), sizeof(published));
+    position += KitePushProducer::MESSAGE_HEADER_SIZE;
+
+    Time latency = Simulator::Now() - NanoSeconds(published);
+    NS_LOG_INFO("Mobile: message " << seq << " delivered after " << latency.GetMilliSeconds() << "ms");
+    m_messageDelivered(seq, latency);
+  }
+
+  FetchBacklog();
+}
+
+void
+KitePushConsumer::OnNack(shared_ptr<const lp::Nack> nack)
+{
+  App::OnNack(nack); // tracing inside
+
+  const Name& name = nack->getInterest().getName();
+  NS_LOG_INFO("Mobile: receive Nack for " << name << ", reason: " << nack->getReason());
+
+  if (!m_active || !m_serverPrefix.isPrefixOf(name) || name.empty() || !name.at(-1).isSequenceNumber())
+    return;
+
+  Name anchor;
+  Name traceName;
+  if (KiteAnchorSelector::ParseAnchorUpdate(name, m_serverPrefix, anchor, traceName))
+    return; // repeated with the next trace anyway
+
+  // not retried right away: the next notification tells that the producer is reachable again
+  uint32_t seq = name.at(-1).toSequenceNumber();
+  m_seqTimeouts.erase(seq);
+  m_retxSeqs.insert(seq);
+
+  m_cwnd = std::max<uint32_t>(1, m_cwnd / 2);
+  m_cwndCredit = 0;
+}
+
+void
+KitePushConsumer::ProbeAnchors()
+{
+  if (!m_active)
+    return;
+
+  // probes still unanswered after one interval count as lost
+  m_anchors.ExpireProbes(m_probeInterval);
+
+  if (m_anchors.Reselect()) {
+    m_anchorUpdatePending = true;
+    SendTrace(); // set up the trace through the new anchor right away
+  }
+
+  for (size_t i = 0; i < m_anchors.GetAnchorCount(); i++) {
+    shared_ptr<Interest> interest = make_shared<Interest>();
+    interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+    interest->setName(m_anchors.MakeProbeName(i));
+    time::milliseconds interestLifeTime(m_probeInterval.GetMilliSeconds());
+    interest->setInterestLifetime(interestLifeTime);
+
+    m_transmittedInterests(interest, this, m_face);
+    m_appLink->onReceiveInterest(*interest);
+  }
+
+  m_probeEvent = Simulator::Schedule(m_probeInterval, &KitePushConsumer::ProbeAnchors, this);
+}
+
+void
+KitePushConsumer::SendAnchorUpdate()
+{
+  Name traceName(m_anchors.GetSelectedAnchor());
+  traceName.append(m_interestName);
+
+  shared_ptr<Interest> interest = make_shared<Interest>();
+  interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+  interest->setName(KiteAnchorSelector::MakeAnchorUpdateName(m_serverPrefix, m_anchors.GetSelectedAnchor(),
+                                                             traceName, m_anchorUpdateSeq++));
+  time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
+  interest->setInterestLifetime(interestLifeTime);
+
+  NS_LOG_INFO("> Anchor update: " << interest->getName());
+
+  m_transmittedInterests(interest, this, m_face);
+  m_appLink->onReceiveInterest(*interest);
+}
+
+void
+KitePushConsumer::SetAnchorPrefixes(const std::string& value)
+{
+  m_anchors.SetAnchors(value);
+  m_anchorPrefixes = value;
+}
+
+std::string
+KitePushConsumer::GetAnchorPrefixes() const
+{
+  return m_anchorPrefixes;
+}
+
 } // namespace ndn
 } // namespace ns3
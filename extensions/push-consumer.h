@@ -25,6 +25,12 @@
 
 #include "ns3/ndnSIM/apps/ndn-consumer.hpp"
 
+#include "ns3/traced-callback.h"
+
+#include "kite-anchor-selector.h"
+
+#include <map>
+
 namespace ns3 {
 namespace ndn {
 
@@ -37,6 +43,16 @@ namespace ndn {
  * In pull scenario, this should run on a mobile node, 
  * and the trace will be set up through an anchor,
  * which is a normal forwarding node that states a special prefix in the topology.
+ *
+ * A notification named <prefix>/<seq> tells the consumer that messages up to seq are available.
+ * The consumer then fetches the backlog with up to Window outstanding Interests,
+ * each asking for BatchSize consecutive messages, and reports the delivery latency of every message.
+ *
+ * With AnchorPrefixes set, the trace <anchor>/<Prefix> is attached to the candidate anchor with the lowest RTT,
+ * and the producer is told about every change of anchor with an anchor update under ServerPrefix.
+ *
+ * A Nack for a fetch Interest marks its messages for retransmission with the next notification
+ * and halves the fetch window, which then grows back by one Interest per window of received Data.
  */
 class KitePushConsumer : public Consumer {
 public:
@@ -51,6 +67,14 @@ public:
   virtual void
   OnInterest(shared_ptr<const Interest> interest);
 
+  virtual void
+  OnData(shared_ptr<const Data> data);
+
+  virtual void
+  OnNack(shared_ptr<const lp::Nack> nack);
+
+  typedef void (*MessageDeliveredCallback)(uint32_t seq, Time latency);
+
 protected:
   // inherited from Application base class.
   virtual void
@@ -60,17 +84,58 @@ protected:
   StopApplication(); // Called at time specified by Stop
 
   /**
-   * \brief Actually does nothing.
+   * \brief Retries the backlog after a timeout, does nothing for periodic notifications.
    */
   virtual void
-  ScheduleNextPacket() {};
+  ScheduleNextPacket();
+
+  /**
+   * @brief Fetch available messages until the window is full
+   */
+  void
+  FetchBacklog();
+
+  void
+  SendFetchInterest(uint32_t seq, uint32_t count);
+
+  /**
+   * @brief Probe all anchors and move the trace if a closer one has been found
+   */
+  void
+  ProbeAnchors();
+
+  void
+  SendAnchorUpdate();
+
+  void
+  SetAnchorPrefixes(const std::string& value);
+
+  std::string
+  GetAnchorPrefixes() const;
 
 private:
   Name m_anchorPrefix;
   Name m_serverPrefix;
   Name m_traceNamePrefix;
   Time m_interestLifeTime; // LifeTime for interest packet(IFI)
-  
+
+  uint32_t m_window;
+  uint32_t m_cwnd;        ///< @brief current fetch window, at most m_window
+  uint32_t m_cwndCredit;  ///< @brief Data received since the window last grew
+  uint32_t m_batchSize;
+  bool m_backlogMode;                     ///< @brief a notification carried the highest available sequence
+  uint32_t m_highestAvailable;
+  std::map<uint32_t, uint32_t> m_batches; ///< @brief first sequence -> number of messages of outstanding fetches
+
+  TracedCallback<uint32_t, Time> m_messageDelivered;
+
+  std::string m_anchorPrefixes;
+  KiteAnchorSelector m_anchors;
+  Time m_probeInterval;
+  EventId m_probeEvent;
+  uint32_t m_anchorUpdateSeq;
+  bool m_anchorUpdatePending;   ///< @brief the producer has not acknowledged the current anchor yet
+  EventId m_traceEvent;
 };
 
 } // namespace ndn
@@ -28,9 +28,15 @@
 #include "ns3/uinteger.h"
 #include "ns3/integer.h"
 #include "ns3/double.h"
+#include "ns3/pointer.h"
 
 #include "helper/ndn-fib-helper.hpp"
 
+#include "kite-anchor-selector.h"
+
+#include <cstring>
+#include <vector>
+
 NS_LOG_COMPONENT_DEFINE("ndn.kite.KitePushProducer");
 
 namespace ns3 {
@@ -56,14 +62,42 @@ KitePushProducer::GetTypeId(void)
       .AddAttribute("TracingInterestLifeTime", "LifeTime for tracing Interest packet", StringValue("2s"),
                     MakeTimeAccessor(&KitePushProducer::m_tracingInterestLifeTime), MakeTimeChecker())
 
+      .AddAttribute("PublishRate", "Messages published per second, 0 to only notify periodically",
+                    DoubleValue(0.0),
+                    MakeDoubleAccessor(&KitePushProducer::m_publishRate), MakeDoubleChecker<double>(0.0))
+
+      .AddAttribute("QueueSize", "Maximum number of published messages kept for fetching",
+                    UintegerValue(1000),
+                    MakeUintegerAccessor(&KitePushProducer::m_queueSize), MakeUintegerChecker<uint32_t>(1))
+
+      .AddAttribute("NotifyInterval", "Minimum interval between two notifications", StringValue("100ms"),
+                    MakeTimeAccessor(&KitePushProducer::m_notifyInterval), MakeTimeChecker())
+
+      .AddAttribute("FollowAnchor", "Send notifications through the anchor announced by the mobile",
+                    BooleanValue(false),
+                    MakeBooleanAccessor(&KitePushProducer::m_followAnchor), MakeBooleanChecker())
+
+      .AddAttribute("ServiceQueue", "Service model in front of the Interest handling of the producer",
+                    TypeId::ATTR_GET, PointerValue(),
+                    MakePointerAccessor(&KitePushProducer::m_serviceQueue),
+                    MakePointerChecker<KiteServiceQueue>())
+
     ;
 
   return tid;
 }
 
+const size_t KitePushProducer::MESSAGE_HEADER_SIZE = sizeof(uint32_t) + sizeof(uint64_t);
+
 KitePushProducer::KitePushProducer()
   : m_rand(CreateObject<UniformRandomVariable>())
   , m_seq(0) 
+  , m_publishRate(0.0)
+  , m_queueSize(1000)
+  , m_dropped(0)
+  , m_payloadSize(1024)
+  , m_followAnchor(false)
+  , m_serviceQueue(CreateObject<KiteServiceQueue>())
 {
   NS_LOG_FUNCTION_NOARGS();
 }
@@ -75,7 +109,20 @@ KitePushProducer::StartApplication()
   NS_LOG_FUNCTION_NOARGS();
   Producer::StartApplication();
 
-  SendInterest();
+  UintegerValue payloadSize;
+  GetAttribute("PayloadSize", payloadSize);
+  m_payloadSize = payloadSize.Get();
+
+  NameValue prefix;
+  GetAttribute("Prefix", prefix);
+  m_appPrefix = prefix.Get();
+
+  if (m_publishRate > 0) {
+    Publish();
+  }
+  else {
+    SendInterest();
+  }
 }
 
 void
@@ -86,7 +133,14 @@ KitePushProducer::SendInterest()
 
   NS_LOG_FUNCTION_NOARGS();
 
-  shared_ptr<Name> name = make_shared<Name>(m_serverPrefix);
+  Simulator::Schedule(Seconds(2.1), &KitePushProducer::SendInterest, this);
+
+  if (m_followAnchor && m_anchor.empty()) {
+    NS_LOG_DEBUG("Server: no anchor announced yet");
+    return;
+  }
+
+  shared_ptr<Name> name = make_shared<Name>(GetNotificationName());
 
   shared_ptr<Interest> interest = make_shared<Interest>();
   interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
@@ -102,16 +156,161 @@ KitePushProducer::SendInterest()
 
   m_transmittedInterests(interest, this, m_face);
   m_appLink->onReceiveInterest(*interest);
+}
 
-  Simulator::Schedule(Seconds(2.1), &KitePushProducer::SendInterest, this);
+void
+KitePushProducer::Publish()
+{
+  if (!m_active)
+    return;
+
+  m_queue.push_back(std::make_pair(m_seq++, Simulator::Now()));
+  if (m_queue.size() > m_queueSize) {
+    m_queue.pop_front();
+    m_dropped++;
+    NS_LOG_DEBUG("Queue full, " << m_dropped << " messages dropped so far");
+  }
+
+  // coalesce notifications of messages published close together
+  if (!m_notifyEvent.IsRunning()) {
+    m_notifyEvent = Simulator::Schedule(m_notifyInterval, &KitePushProducer::Notify, this);
+  }
+
+  Simulator::Schedule(Seconds(1.0 / m_publishRate), &KitePushProducer::Publish, this);
+}
+
+void
+KitePushProducer::Notify()
+{
+  if (!m_active || m_queue.empty())
+    return;
+
+  if (m_followAnchor && m_anchor.empty()) {
+    NS_LOG_DEBUG("Server: no anchor announced yet");
+    m_notifyEvent = Simulator::Schedule(m_notifyInterval, &KitePushProducer::Notify, this);
+    return;
+  }
+
+  shared_ptr<Name> name = make_shared<Name>(GetNotificationName());
+  name->appendSequenceNumber(m_queue.back().first);
+
+  shared_ptr<Interest> interest = make_shared<Interest>();
+  interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+  interest->setName(*name);
+  interest->setTraceName(m_traceNamePrefix);
+  time::milliseconds interestLifeTime(m_tracingInterestLifeTime.GetMilliSeconds());
+  interest->setInterestLifetime(interestLifeTime);
+
+  interest->setTraceFlag(2);
+
+  NS_LOG_INFO("> Server: Notification up to " << m_queue.back().first << ", Name: " << interest->getName()
+              << ", TraceName: " << interest->getTraceName());
+
+  m_transmittedInterests(interest, this, m_face);
+  m_appLink->onReceiveInterest(*interest);
+}
+
+Name
+KitePushProducer::GetNotificationName() const
+{
+  Name name(m_followAnchor ? m_anchor : Name());
+  name.append(m_serverPrefix);
+  return name;
+}
+
+void
+KitePushProducer::SendMessages(shared_ptr<const Interest> interest)
+{
+  const Name& interestName = interest->getName();
+
+  uint32_t first = interestName.at(-1).toSequenceNumber();
+  uint32_t count = 1;
+  if (interestName.size() >= 3 && interestName.get(-3) == ::ndn::name::Component("batch")) {
+    if (!interestName.get(-2).isNumber()) {
+      NS_LOG_DEBUG("Malformed batch size in " << interestName << ", ignoring");
+      return;
+    }
+    count = std::max<uint32_t>(1, interestName.get(-2).toNumber());
+  }
+
+  // messages that were dropped from the queue or not yet published are simply absent from the batch
+  std::vector<std::pair<uint32_t, Time>> messages;
+  for (const auto& message : m_queue) {
+    if (message.first >= first && message.first - first < count) {
+      messages.push_back(message);
+    }
+  }
+
+  uint32_t messageCount = messages.size();
+  auto buffer = make_shared< ::ndn::Buffer>(sizeof(messageCount)
+                                            + messageCount * (MESSAGE_HEADER_SIZE + m_payloadSize));
+  uint8_t* position = buffer->get();
+  std::memcpy(position, &messageCount, sizeof(messageCount));
+  position += sizeof(messageCount);
+  for (const auto& message : messages) {
+    uint32_t seq = message.first;
+    uint64_t published = message.second.GetNanoSeconds();
+    std::memcpy(position, &seq, sizeof(seq));
+    std::memcpy(position + sizeof(seq), &published, sizeof(published));
+    position += MESSAGE_HEADER_SIZE;
+  }
+
+  auto data = make_shared<Data>();
+  data->setName(interestName);
+  data->setFreshnessPeriod(::ndn::time::milliseconds(0));
+  data->setContent(buffer);
+
+  Signature signature;
+  SignatureInfo signatureInfo(static_cast< ::ndn::tlv::SignatureTypeValue>(255));
+  signature.setInfo(signatureInfo);
+  signature.setValue(::ndn::makeNonNegativeIntegerBlock(::ndn::tlv::SignatureValue, 0));
+  data->setSignature(signature);
+
+  NS_LOG_INFO("node(" << GetNode()->GetId() << ") responding with " << messages.size() << " messages: "
+              << data->getName());
+
+  data->wireEncode();
+
+  m_transmittedDatas(data, this, m_face);
+  m_appLink->onReceiveData(*data);
 }
 
 void 
 KitePushProducer::OnInterest(shared_ptr<const Interest> interest)
+{
+  if (!m_serviceQueue->Enqueue(std::bind(&KitePushProducer::ProcessInterest, this, interest))) {
+    NS_LOG_INFO("Server: overloaded, dropping Interest: " << interest->getName());
+  }
+}
+
+void
+KitePushProducer::ProcessInterest(shared_ptr<const Interest> interest)
 {
   NS_LOG_INFO("Server: receive Interest: " << interest->getName());
+
+  Name anchor;
+  Name traceName;
+  if (KiteAnchorSelector::ParseAnchorUpdate(interest->getName(), m_appPrefix, anchor, traceName)) {
+    if (anchor != m_anchor) {
+      NS_LOG_INFO("Server: mobile moved its trace " << traceName << " to anchor " << anchor);
+    }
+    m_anchor = anchor;
+    m_traceNamePrefix = traceName;
+
+    Producer::OnInterest(interest); // acknowledge, so that the mobile stops repeating the update
+    return;
+  }
+
   if (!interest->getTraceFlag()) {
-    Producer::OnInterest(interest);
+    if (m_publishRate > 0 && !interest->getName().empty() && interest->getName().at(-1).isSequenceNumber()) {
+      App::OnInterest(interest); // tracing inside
+      if (m_active) {
+        SendMessages(interest);
+      }
+    }
+    else {
+      Producer::OnInterest(interest);
+    }
   }
 }
 
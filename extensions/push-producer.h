@@ -28,6 +28,10 @@
 
 #include "ns3/ndnSIM/apps/ndn-producer.hpp"
 
+#include "kite-service-queue.h"
+
+#include <deque>
+
 namespace ns3 {
 namespace ndn {
 
@@ -39,6 +43,20 @@ namespace ndn {
  * Currently, the name of the uploading mobile node is fixed.
  * Eventually the upload request should include information about the mobile node,
  * and certain verification machanisms should be applied so that this won't be exploited to conduct DDoS attacks.
+ *
+ * With PublishRate set, the producer publishes messages into a bounded queue at that rate,
+ * and notifies the mobile with tracing Interests named <ServerPrefix>/<highest available seq>,
+ * at most once per NotifyInterval.  Fetch Interests named <prefix>/<seq> or <prefix>/batch/<k>/<seq>
+ * are answered with one Data carrying up to k consecutive messages.
+ *
+ * Message Data content is the 32-bit number of messages, then for each message the 32-bit sequence number
+ * and the 64-bit publication time in nanoseconds, then PayloadSize bytes of payload per message.
+ *
+ * With FollowAnchor set, ServerPrefix is relative to the anchor announced by the mobile's latest anchor update:
+ * notifications are named <anchor>/<ServerPrefix>[/<seq>] and carry the announced trace name.
+ *
+ * Interests are handled through the ServiceQueue of the producer, which takes no time unless
+ * its Workers are set, see KiteServiceQueue.
  */
 class KitePushProducer : public Producer {
 public:
@@ -51,13 +69,45 @@ public:
   virtual void 
   OnInterest(shared_ptr<const Interest> interest);
 
+  /**
+   * @brief Handle an Interest once the service queue gets to it
+   */
+  void
+  ProcessInterest(shared_ptr<const Interest> interest);
+
   /**
    * @brief Actually send packet, with TraceFlag option
    */
   void
   SendInterest();
 
+  /**
+   * @brief Size of the per-message header preceding the payload in message Data
+   */
+  static const size_t MESSAGE_HEADER_SIZE;
+
 protected:
+  /**
+   * @brief Put a new message into the queue and schedule a notification
+   */
+  void
+  Publish();
+
+  /**
+   * @brief Notify the mobile of the highest available sequence number
+   */
+  void
+  Notify();
+
+  void
+  SendMessages(shared_ptr<const Interest> interest);
+
+  /**
+   * @brief Name of the notifications, following the mobile's anchor if requested
+   */
+  Name
+  GetNotificationName() const;
+
   // from App
   virtual void
   StartApplication();
@@ -78,6 +128,20 @@ protected:
   std::string m_randomType;
   
   int m_seq;
+
+  double m_publishRate;   ///< @brief messages per second, 0 for the periodic notification only
+  uint32_t m_queueSize;
+  Time m_notifyInterval;
+  std::deque<std::pair<uint32_t, Time>> m_queue; ///< @brief published messages and their publication time
+  uint32_t m_dropped;
+  uint32_t m_payloadSize; ///< @brief PayloadSize of the Producer, per message
+  EventId m_notifyEvent;
+
+  bool m_followAnchor;
+  Name m_anchor;    ///< @brief anchor of the last anchor update, empty if none was received
+  Name m_appPrefix; ///< @brief Prefix of the Producer, anchor updates arrive under it
+
+  Ptr<KiteServiceQueue> m_serviceQueue;
 };
 
 } // namespace ndn
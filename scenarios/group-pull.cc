@@ -0,0 +1,223 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2017 Harbin Institute of Technology, China
+ *
+ * Author: Peng Yu
+ **/
+
+// group-pull.cpp
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/ndnSIM-module.h"
+
+#include "ns3/wifi-module.h"
+#include "ns3/mobility-module.h"
+
+#include "pull-server.h"
+#include "kite-group-router.h"
+#include "kite-state-tracer.h"
+#include "kite-overhead-tracer.h"
+
+#include "fw/kite-trace-strategy.hpp"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE("ndn.kite.GroupPull");
+
+/**
+ * Topology of simple-pull, where every mobile is a vehicle carrying devices behind it,
+ * each device on its own point-to-point link to the vehicle.
+ * The server at node 2 pulls from every device through the anchor at node 0.
+ *
+ * Every device answers with a Producer.  With --group, the vehicle runs a KiteGroupRouter keeping
+ * a single trace for all its devices; otherwise every device runs a KiteGroupRouter of its own, a group
+ * of one keeping the device's trace, and its trace crosses the vehicle.  Both modes carry the same
+ * Interests and Data apart from the traces, so their control traffic per delivered byte compares.
+ */
+int
+main(int argc, char* argv[])
+{
+  // LogComponentEnable("nfd.KiteTraceStrategy", LOG_LEVEL_INFO);
+  // LogComponentEnable("ndn.kite.KiteGroupRouter", LOG_LEVEL_INFO);
+
+  // setting default parameters for PointToPoint links and channels
+  Config::SetDefault("ns3::PointToPointNetDevice::DataRate", StringValue("1Mbps"));
+  Config::SetDefault("ns3::PointToPointChannel::Delay", StringValue("10ms"));
+  Config::SetDefault("ns3::DropTailQueue::MaxPackets", StringValue("20"));
+
+  int speed = 100;
+  int stopTime = 20;
+  uint32_t vehicles = 1;
+  uint32_t devices = 10;
+  bool group = true;
+
+  // Read optional command-line parameters (e.g., enable visualizer with ./waf --run=<> --visualize
+  CommandLine cmd;
+  cmd.AddValue("speed", "vehicle speed m/s", speed);
+  cmd.AddValue("stop", "stop time", stopTime);
+  cmd.AddValue("vehicles", "# vehicles", vehicles);
+  cmd.AddValue("devices", "# devices behind every vehicle", devices);
+  cmd.AddValue("group", "keep one trace per vehicle instead of one per device", group);
+  cmd.Parse(argc, argv);
+
+  // Creating nodes
+  NodeContainer nodes;
+  nodes.Create(6);
+
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> posAlloc = CreateObject<ListPositionAllocator> ();
+  posAlloc->Add (Vector (0.0, 0.0, 0.0));
+  posAlloc->Add (Vector (0.0, 100.0, 0.0));
+  posAlloc->Add (Vector (-100.0, 200.0, 0.0));
+  posAlloc->Add (Vector (100.0, 200.0, 0.0));
+  posAlloc->Add (Vector (0.0, 300.0, 0.0));
+  posAlloc->Add (Vector (200.0, 300.0, 0.0));
+  mobility.SetPositionAllocator (posAlloc);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+
+  PointToPointHelper p2p;
+  p2p.Install(nodes.Get(0), nodes.Get(1));
+  p2p.Install(nodes.Get(1), nodes.Get(2));
+  p2p.Install(nodes.Get(1), nodes.Get(3));
+  p2p.Install(nodes.Get(3), nodes.Get(4));
+  p2p.Install(nodes.Get(3), nodes.Get(5));
+
+  // Vehicles roam under the access points at nodes 4 and 5
+  NodeContainer vehicleNodes;
+  vehicleNodes.Create (vehicles);
+
+  Ptr<RandomRectanglePositionAllocator> randomPosAlloc = CreateObject<RandomRectanglePositionAllocator> ();
+  Ptr<UniformRandomVariable> x = CreateObject<UniformRandomVariable> ();
+  x->SetAttribute ("Min", DoubleValue (0));
+  x->SetAttribute ("Max", DoubleValue (200));
+  randomPosAlloc->SetX (x);
+  Ptr<UniformRandomVariable> y = CreateObject<UniformRandomVariable> ();
+  y->SetAttribute ("Min", DoubleValue (300));
+  y->SetAttribute ("Max", DoubleValue (350));
+  randomPosAlloc->SetY (y);
+
+  mobility.SetPositionAllocator(randomPosAlloc);
+  std::stringstream ss;
+  ss << "ns3::UniformRandomVariable[Min=" << speed << "|Max=" << speed << "]";
+
+  mobility.SetMobilityModel ("ns3::RandomWalk2dMobilityModel",
+    "Bounds", RectangleValue (Rectangle (0, 200, 300, 350)),
+    "Distance", DoubleValue (200),
+    "Speed", StringValue (ss.str ()));
+  mobility.Install (vehicleNodes);
+
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211a);
+  NqosWifiMacHelper wifiMac = NqosWifiMacHelper::Default ();
+  wifiMac.SetType ("ns3::AdhocWifiMac");
+  std::string phyMode ("OfdmRate54Mbps");
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager", "DataMode",StringValue (phyMode), "ControlMode",StringValue (phyMode));
+
+  YansWifiPhyHelper wifiPhy = YansWifiPhyHelper::Default ();
+  wifiPhy.SetPcapDataLinkType (YansWifiPhyHelper::DLT_IEEE802_11_RADIO);
+  YansWifiChannelHelper wifiChannel;
+  wifiChannel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
+  wifiChannel.AddPropagationLoss ("ns3::LogDistancePropagationLossModel", "Exponent", DoubleValue (3));
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  NetDeviceContainer vehicleRadios = wifi.Install (wifiPhy, wifiMac, vehicleNodes);
+  wifi.Install (wifiPhy, wifiMac, nodes.Get(4));
+  wifi.Install (wifiPhy, wifiMac, nodes.Get(5));
+
+  // Devices, deviceNodes.Get(v * devices + i) is device i of vehicle v
+  NodeContainer deviceNodes;
+  deviceNodes.Create (vehicles * devices);
+  for (uint32_t v = 0; v < vehicles; v++) {
+    for (uint32_t i = 0; i < devices; i++) {
+      p2p.Install(vehicleNodes.Get(v), deviceNodes.Get(v * devices + i));
+    }
+  }
+
+  ndn::StackHelper ndnHelper;
+  ndnHelper.SetDefaultRoutes(true);
+  ndnHelper.InstallAll();
+
+  ndn::StrategyChoiceHelper::InstallAll<nfd::fw::KiteTraceStrategy>("/");
+
+  std::string serverPrefix = "/server";
+  std::string anchorPrefix = "/anchor";
+
+  ndn::FibHelper::AddRoute (nodes.Get(1), anchorPrefix, nodes.Get(0), 1);
+  ndn::FibHelper::AddRoute (nodes.Get(2), anchorPrefix, nodes.Get(1), 1);
+  ndn::FibHelper::AddRoute (nodes.Get(3), anchorPrefix, nodes.Get(1), 1);
+  ndn::FibHelper::AddRoute (nodes.Get(4), anchorPrefix, nodes.Get(3), 1);
+  ndn::FibHelper::AddRoute (nodes.Get(5), anchorPrefix, nodes.Get(3), 1);
+
+  for (uint32_t v = 0; v < vehicles; v++) {
+    Ptr<Node> vehicle = vehicleNodes.Get(v);
+    std::string vehiclePrefix = "/vehicle" + std::to_string(v);
+
+    // traces leave the vehicle over its radio, never back to a device
+    shared_ptr<ndn::Face> radio = vehicle->GetObject<ndn::L3Protocol>()->getFaceByNetDevice(vehicleRadios.Get(v));
+    ndn::FibHelper::AddRoute (vehicle, anchorPrefix, radio, 1);
+
+    if (group) {
+      ndn::AppHelper routerHelper("ns3::ndn::KiteGroupRouter");
+      routerHelper.SetAttribute("AnchorPrefix", StringValue(anchorPrefix + vehiclePrefix));
+      routerHelper.SetAttribute("GroupPrefix", StringValue(vehiclePrefix));
+      routerHelper.Install(vehicle);
+    }
+
+    for (uint32_t i = 0; i < devices; i++) {
+      Ptr<Node> device = deviceNodes.Get(v * devices + i);
+      std::string devicePrefix = vehiclePrefix + "/dev" + std::to_string(i);
+
+      ndn::FibHelper::AddRoute (vehicle, devicePrefix, device, 1);
+      ndn::FibHelper::AddRoute (device, anchorPrefix, vehicle, 1);
+
+      // Server pulling from the device, through the group trace or the device's own one
+      ndn::AppHelper serverHelper("ns3::ndn::KitePullServer");
+      serverHelper.SetPrefix(anchorPrefix + devicePrefix);
+      serverHelper.SetAttribute("TraceNamePrefix", StringValue(anchorPrefix + (group ? vehiclePrefix : devicePrefix)));
+      serverHelper.SetAttribute("ServerPrefix", StringValue(serverPrefix));
+      ApplicationContainer consumerApp = serverHelper.Install(nodes.Get(2));
+      consumerApp.Start(Seconds(3));
+
+      ndn::AppHelper deviceHelper("ns3::ndn::Producer");
+      deviceHelper.SetPrefix(devicePrefix);
+      deviceHelper.SetAttribute("PayloadSize", StringValue("1024"));
+      deviceHelper.Install(device);
+
+      if (!group) {
+        // the device keeps its own trace, answered through the same Producer
+        ndn::AppHelper traceHelper("ns3::ndn::KiteGroupRouter");
+        traceHelper.SetAttribute("AnchorPrefix", StringValue(anchorPrefix + devicePrefix));
+        traceHelper.SetAttribute("GroupPrefix", StringValue(devicePrefix));
+        traceHelper.Install(device);
+      }
+    }
+  }
+
+  // Traced Interests show up in the rate trace, forwarder trace entries in the state trace
+  ndn::L3RateTracer::InstallAll("rate-trace.txt", Seconds(5.0));
+  ndn::KiteStateTracer::InstallAll("state-trace.txt", Seconds(5.0));
+  ndn::KiteOverheadTracer::InstallAll("overhead-trace.txt", Seconds(5.0));
+
+  Simulator::Stop(Seconds(stopTime));
+
+  Simulator::Run();
+
+  // Control bytes per delivered payload byte over the whole run
+  AsciiTraceHelper asciiTraceHelper;
+  Ptr<OutputStreamWrapper> overheadStream = asciiTraceHelper.CreateFileStream("overhead-report.txt");
+  ndn::KiteOverheadTracer::PrintReport(*overheadStream->GetStream());
+
+  Simulator::Destroy();
+
+  return 0;
+}
+
+} // namespace ns3
+
+int
+main(int argc, char* argv[])
+{
+  return ns3::main(argc, argv);
+}
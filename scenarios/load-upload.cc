@@ -0,0 +1,132 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2017 Harbin Institute of Technology, China
+ *
+ * Author: Peng Yu
+ **/
+
+// load-upload.cpp
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/point-to-point-layout-module.h"
+#include "ns3/ndnSIM-module.h"
+
+#include "ndn-kite-upload-server.h"
+#include "kite-load-generator.h"
+#include "kite-state-tracer.h"
+#include "kite-overhead-tracer.h"
+
+#include "fw/kite-trace-strategy.hpp"
+#include "kite-shortcut-strategy.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE("ndn.kite.LoadUpload");
+
+/**
+ * Upload server at grid node (0, 0) loaded by many virtual mobiles,
+ * all run by a KiteLoadGenerator at the opposite corner of the grid.
+ */
+int
+main(int argc, char* argv[])
+{
+  // LogComponentEnable("ndn.kite.KiteUploadServer", LOG_LEVEL_INFO);
+  // LogComponentEnable("ndn.kite.KiteLoadGenerator", LOG_LEVEL_INFO);
+
+  // setting default parameters for PointToPoint links and channels
+  Config::SetDefault("ns3::PointToPointNetDevice::DataRate", StringValue("10Mbps"));
+  Config::SetDefault("ns3::PointToPointChannel::Delay", StringValue("10ms"));
+  Config::SetDefault("ns3::DropTailQueue::MaxPackets", StringValue("100"));
+
+  int gridSize = 3;
+  uint32_t mobiles = 1000;
+  double interval = 1.0;
+  uint32_t segments = 0;
+  int stopTime = 20;
+  bool shortcut = false;
+
+  // Read optional command-line parameters (e.g., enable visualizer with ./waf --run=<> --visualize
+  CommandLine cmd;
+  cmd.AddValue("grid", "grid size", gridSize);
+  cmd.AddValue("mobiles", "# virtual mobiles", mobiles);
+  cmd.AddValue("interval", "seconds between two upload requests of a virtual mobile", interval);
+  cmd.AddValue("segments", "# segments of a bulk upload, 0 for an endless stream", segments);
+  cmd.AddValue("stop", "stop time", stopTime);
+  cmd.AddValue("shortcut", "keep traces in the compact table of the shortcut strategy", shortcut);
+  cmd.Parse(argc, argv);
+
+  // Creating nodes
+  PointToPointHelper p2p;
+  PointToPointGridHelper grid (gridSize, gridSize, p2p);
+  grid.BoundingBox(0,0,400,400);
+
+  ndn::StackHelper ndnHelper;
+  ndnHelper.SetDefaultRoutes(true);
+  ndnHelper.InstallAll();
+
+  if (shortcut)
+    ndn::StrategyChoiceHelper::InstallAll<nfd::fw::KiteShortcutStrategy>("/");
+  else
+    ndn::StrategyChoiceHelper::InstallAll<nfd::fw::KiteTraceStrategy>("/");
+
+  std::string serverPrefix = "/server";
+  std::string mobilePrefix = "/vmobile";
+
+  for (int i = 0; i<gridSize; i++)
+  {
+    for (int j = 0; j<gridSize; j++)
+    {
+        if (i ==0 && j==0) continue;
+        int m = i>j ? (i - 1) : i;
+        int n = i>j ? j : (j - 1);
+        ndn::FibHelper::AddRoute (grid.GetNode (i, j), serverPrefix, grid.GetNode (m, n), 1);
+    }
+  }
+
+  // Installing applications
+  // Stationary server
+  ndn::AppHelper serverHelper("ns3::ndn::KiteUploadServer");
+  serverHelper.SetPrefix(mobilePrefix);
+  serverHelper.SetAttribute("ServerPrefix", StringValue(serverPrefix));
+  serverHelper.Install(grid.GetNode(0, 0));
+
+  // Virtual mobiles
+  ndn::AppHelper loadHelper("ns3::ndn::KiteLoadGenerator");
+  loadHelper.SetAttribute("ServerPrefix", StringValue(serverPrefix));
+  loadHelper.SetAttribute("MobilePrefix", StringValue(mobilePrefix));
+  loadHelper.SetAttribute("MobileCount", UintegerValue(mobiles));
+  loadHelper.SetAttribute("TraceInterval", TimeValue(Seconds(interval)));
+  loadHelper.SetAttribute("ObjectSize", UintegerValue(segments));
+  loadHelper.Install(grid.GetNode(gridSize - 1, gridSize - 1));
+
+  AsciiTraceHelper asciiTraceHelper;
+
+  // Completion time and goodput of bulk uploads
+  ndn::KiteUploadServer::TraceCompletions("upload-completion.txt");
+
+  ndn::L3RateTracer::InstallAll("rate-trace.txt", Seconds(1));
+  ndn::KiteStateTracer::InstallAll("state-trace.txt", Seconds(1));
+  ndn::KiteOverheadTracer::InstallAll("overhead-trace.txt", Seconds(1));
+
+  Simulator::Stop(Seconds(stopTime));
+
+  Simulator::Run();
+
+  // Control bytes per delivered payload byte over the whole run
+  Ptr<OutputStreamWrapper> overheadStream = asciiTraceHelper.CreateFileStream("overhead-report.txt");
+  ndn::KiteOverheadTracer::PrintReport(*overheadStream->GetStream());
+
+  Simulator::Destroy();
+
+  return 0;
+}
+
+} // namespace ns3
+
+int
+main(int argc, char* argv[])
+{
+  return ns3::main(argc, argv);
+}
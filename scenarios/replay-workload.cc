@@ -0,0 +1,105 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2017 Harbin Institute of Technology, China
+ *
+ * Author: Peng Yu
+ **/
+
+// replay-workload.cpp
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/point-to-point-layout-module.h"
+#include "ns3/ndnSIM-module.h"
+
+#include "kite-workload-replay.h"
+#include "kite-state-tracer.h"
+
+#include "fw/kite-trace-strategy.hpp"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE("ndn.kite.ReplayWorkload");
+
+/**
+ * Replays a workload recorded with --record by wifi-upload or topo-upload on a point-to-point grid,
+ * without wifi or mobility: every recorded node with packets is mapped to a grid node, spread over the grid.
+ */
+int
+main(int argc, char* argv[])
+{
+  // LogComponentEnable("ndn.kite.KiteWorkloadReplay", LOG_LEVEL_INFO);
+
+  // setting default parameters for PointToPoint links and channels
+  Config::SetDefault("ns3::PointToPointNetDevice::DataRate", StringValue("1Mbps"));
+  Config::SetDefault("ns3::PointToPointChannel::Delay", StringValue("10ms"));
+  Config::SetDefault("ns3::DropTailQueue::MaxPackets", StringValue("20"));
+
+  std::string file = "workload.bin";
+  int gridSize = 3;
+  int stopTime = 100;
+
+  // Read optional command-line parameters (e.g., enable visualizer with ./waf --run=<> --visualize
+  CommandLine cmd;
+  cmd.AddValue("file", "workload log to replay", file);
+  cmd.AddValue("grid", "grid size", gridSize);
+  cmd.AddValue("stop", "stop time", stopTime);
+  cmd.Parse(argc, argv);
+
+  std::set<uint32_t> recordedNodes = ndn::KiteWorkloadReplay::GetNodes(file);
+  if (recordedNodes.empty()) {
+    NS_LOG_ERROR("Nothing to replay in " << file);
+    return 1;
+  }
+
+  // Creating nodes
+  PointToPointHelper p2p;
+  PointToPointGridHelper grid (gridSize, gridSize, p2p);
+  grid.BoundingBox(0,0,400,400);
+
+  ndn::StackHelper ndnHelper;
+  ndnHelper.InstallAll();
+
+  ndn::StrategyChoiceHelper::InstallAll<nfd::fw::KiteTraceStrategy>("/");
+
+  ndn::GlobalRoutingHelper ndnGlobalRoutingHelper;
+  ndnGlobalRoutingHelper.InstallAll();
+
+  // Installing applications
+  uint32_t gridNodes = gridSize * gridSize;
+  uint32_t k = 0;
+  for (uint32_t recorded : recordedNodes) {
+    uint32_t position = (k++ * gridNodes / recordedNodes.size()) % gridNodes;
+    Ptr<Node> node = grid.GetNode(position / gridSize, position % gridSize);
+
+    ndn::AppHelper replayHelper("ns3::ndn::KiteWorkloadReplay");
+    replayHelper.SetAttribute("File", StringValue(file));
+    replayHelper.SetAttribute("SourceNode", UintegerValue(recorded));
+    replayHelper.Install(node);
+
+    for (const ndn::Name& prefix : ndn::KiteWorkloadReplay::GetServedPrefixes(file, recorded)) {
+      ndnGlobalRoutingHelper.AddOrigin(prefix.toUri(), node);
+    }
+  }
+
+  ndn::GlobalRoutingHelper::CalculateRoutes();
+
+  ndn::L3RateTracer::InstallAll("rate-trace.txt", Seconds(1));
+  ndn::KiteStateTracer::InstallAll("state-trace.txt", Seconds(1));
+
+  Simulator::Stop(Seconds(stopTime));
+
+  Simulator::Run();
+  Simulator::Destroy();
+
+  return 0;
+}
+
+} // namespace ns3
+
+int
+main(int argc, char* argv[])
+{
+  return ns3::main(argc, argv);
+}
@@ -17,8 +17,14 @@
 
 #include "pull-server.h"
 #include "pull-mobile.h"
+#include "kite-handoff-tracer.h"
+#include "kite-state-tracer.h"
+#include "kite-overhead-tracer.h"
+#include "kite-path-stretch-tracer.h"
+#include "kite-background-traffic.h"
 
 #include "fw/kite-trace-strategy.hpp"
+#include "kite-shortcut-strategy.h"
 
 namespace ns3 {
 
@@ -35,6 +41,7 @@ main(int argc, char* argv[])
   // LogComponentEnable("ndn.kite.KiteUploadMobile", LOG_LEVEL_INFO);
 
   // LogComponentEnable("nfd.TraceTable", LOG_LEVEL_INFO);
+  // LogComponentEnable("nfd.KiteShortcutStrategy", LOG_LEVEL_INFO);
 
   // setting default parameters for PointToPoint links and channels
   Config::SetDefault("ns3::PointToPointNetDevice::DataRate", StringValue("1Mbps"));
@@ -48,6 +55,13 @@ main(int argc, char* argv[])
   int speed = 100;        //100
   int stopTime = 100;
   int joinTime = 1;
+  bool multiAnchor = false;
+  bool predict = false;
+  bool announceTraces = false;
+  bool shortcut = false;
+  uint32_t background = 0;
+  double load = 0.7;
+  bool bursty = false;
 
   // Read optional command-line parameters (e.g., enable visualizer with ./waf --run=<> --visualize
   CommandLine cmd;
@@ -57,6 +71,13 @@ main(int argc, char* argv[])
   cmd.AddValue("grid", "grid size", gridSize);  
   cmd.AddValue("stop", "stop time", stopTime);  
   cmd.AddValue("join", "join period", joinTime); 
+  cmd.AddValue("multianchor", "let the mobile choose between anchors at node 0 and node 3", multiAnchor);
+  cmd.AddValue("predict", "set up the trace through the next access point as soon as it is reached", predict);
+  cmd.AddValue("refresh", "announce every trace to the server, which then re-sends its pending Interests", announceTraces);
+  cmd.AddValue("shortcut", "send tracing Interests down a trace already known to the router, without visiting the anchor", shortcut);
+  cmd.AddValue("background", "# background consumer/producer pairs across the backbone, 0 for none", background);
+  cmd.AddValue("load", "share of the capacity of every backbone link the background pairs use together", load);
+  cmd.AddValue("bursty", "send background traffic in exponential on/off bursts instead of at a constant rate", bursty);
   cmd.Parse(argc, argv);
 
   // Creating nodes
@@ -146,7 +167,10 @@ main(int argc, char* argv[])
   // Choosing forwarding strategy
   //ndn::StrategyChoiceHelper::Install(nodes.Get(0), "/", "/localhost/nfd/strategy/kite-trace");
   //ndn::StrategyChoiceHelper::InstallAll("/", "/localhost/nfd/strategy/kite-trace");
-  ndn::StrategyChoiceHelper::InstallAll<nfd::fw::KiteTraceStrategy>("/");
+  if (shortcut)
+    ndn::StrategyChoiceHelper::InstallAll<nfd::fw::KiteShortcutStrategy>("/");
+  else
+    ndn::StrategyChoiceHelper::InstallAll<nfd::fw::KiteTraceStrategy>("/");
   //ndn::StrategyChoiceHelper::InstallAll<nfd::fw::KiteTraceStrategy>("/");
 
   std::string serverPrefix = "/server";
@@ -159,11 +183,42 @@ main(int argc, char* argv[])
   ndn::FibHelper::AddRoute (nodes.Get(4), anchorPrefix, nodes.Get(3), 1);
   ndn::FibHelper::AddRoute (nodes.Get(5), anchorPrefix, nodes.Get(3), 1);
 
+  // Add route of prefix: /server, for anchor updates and trace refreshes
+  ndn::FibHelper::AddRoute (nodes.Get(5), serverPrefix, nodes.Get(3), 1);
+  ndn::FibHelper::AddRoute (nodes.Get(4), serverPrefix, nodes.Get(3), 1);
+  ndn::FibHelper::AddRoute (nodes.Get(3), serverPrefix, nodes.Get(1), 1);
+  ndn::FibHelper::AddRoute (nodes.Get(0), serverPrefix, nodes.Get(1), 1);
+  ndn::FibHelper::AddRoute (nodes.Get(1), serverPrefix, nodes.Get(2), 1);
+
+  // Second anchor next to the access points, the mobile picks the closer one
+  std::string nearAnchorPrefix = "/near-anchor";
+  if (multiAnchor) {
+    ndn::FibHelper::AddRoute (nodes.Get(0), nearAnchorPrefix, nodes.Get(1), 1);
+    ndn::FibHelper::AddRoute (nodes.Get(1), nearAnchorPrefix, nodes.Get(3), 1);
+    ndn::FibHelper::AddRoute (nodes.Get(2), nearAnchorPrefix, nodes.Get(1), 1);
+    ndn::FibHelper::AddRoute (nodes.Get(4), nearAnchorPrefix, nodes.Get(3), 1);
+    ndn::FibHelper::AddRoute (nodes.Get(5), nearAnchorPrefix, nodes.Get(3), 1);
+
+    // Anchors answer RTT probes
+    ndn::AppHelper probeHelper("ns3::ndn::Producer");
+    probeHelper.SetAttribute("PayloadSize", StringValue("16"));
+    probeHelper.SetPrefix(anchorPrefix + "/probe");
+    probeHelper.Install(nodes.Get(0));
+    probeHelper.SetPrefix(nearAnchorPrefix + "/probe");
+    probeHelper.Install(nodes.Get(3));
+  }
+
   // Installing applications
   // Stationary server
   ndn::AppHelper serverHelper("ns3::ndn::KitePullServer");
-  serverHelper.SetPrefix(anchorPrefix + "/geoloc");                     //m_interestName of Server app will send at Start-time.
-  serverHelper.SetAttribute("TraceNamePrefix", StringValue(anchorPrefix + mobilePrefix));
+  if (multiAnchor) {
+    serverHelper.SetPrefix("/geoloc");                                  // relative to the announced anchor
+    serverHelper.SetAttribute("FollowAnchor", BooleanValue(true));
+  }
+  else {
+    serverHelper.SetPrefix(anchorPrefix + "/geoloc");                   //m_interestName of Server app will send at Start-time.
+    serverHelper.SetAttribute("TraceNamePrefix", StringValue(anchorPrefix + mobilePrefix));
+  }
   serverHelper.SetAttribute("ServerPrefix", StringValue(serverPrefix));
   ApplicationContainer consumerApp = serverHelper.Install(nodes.Get(2));                        // consumer node
   consumerApp.Start(Seconds(3));
@@ -174,16 +229,50 @@ main(int argc, char* argv[])
   mobileNodeHelper.SetPrefix(mobilePrefix);
 
   mobileNodeHelper.SetAttribute("AnchorPrefix", StringValue(anchorPrefix + mobilePrefix));
+  if (multiAnchor) {
+    mobileNodeHelper.SetAttribute("AnchorPrefixes", StringValue(anchorPrefix + " " + nearAnchorPrefix));
+  }
   mobileNodeHelper.SetAttribute("ServerPrefix", StringValue(serverPrefix));
   mobileNodeHelper.SetAttribute("PayloadSize", StringValue("1024"));
+  mobileNodeHelper.SetAttribute("AnnounceTraces", BooleanValue(announceTraces));
+  if (predict) {
+    Config::SetDefault("ns3::ndn::KiteHandoffPredictor::AccessPoints", StringValue("0:300 200:300")); // positions of the wifi-enabled routers
+  }
   mobileNodeHelper.Install(mobileNodes.Get(0)); // mobile producer node
 
+  // Measure outage after every change of access point
+  NodeContainer accessPoints;
+  accessPoints.Add(nodes.Get(4));
+  accessPoints.Add(nodes.Get(5));
+  // (the near anchor wins the RTT comparison when there is a choice)
+  ndn::KiteHandoffTracer::Install(mobileNodes.Get(0), accessPoints, nodes.Get(multiAnchor ? 3 : 0),
+                                  "handoff-trace.txt", "handoff-histogram.txt");
+
   L2RateTracer::InstallAll("drop-trace.txt", Seconds(5.0));
   ndn::L3RateTracer::InstallAll("rate-trace.txt", Seconds(5.0));
+  ndn::KiteStateTracer::InstallAll("state-trace.txt", Seconds(5.0));
+  ndn::KiteOverheadTracer::InstallAll("overhead-trace.txt", Seconds(5.0));
+  ndn::KitePathStretchTracer::InstallAll("path-stretch.txt", Seconds(1.0));
+
+  // Background load on the backbone, with --background set (after the tracers: its Data is not payload)
+  if (background > 0) {
+    ndn::KiteBackgroundTraffic backgroundTraffic;
+    backgroundTraffic.SetLoad(load);
+    if (bursty) {
+      backgroundTraffic.SetBursty(Seconds(0.5), Seconds(0.5));
+    }
+    backgroundTraffic.InstallAcross(nodes, background);
+  }
 
   Simulator::Stop(Seconds(20.0));
 
   Simulator::Run();
+
+  // Control bytes per delivered payload byte over the whole run
+  AsciiTraceHelper asciiTraceHelper;
+  Ptr<OutputStreamWrapper> overheadStream = asciiTraceHelper.CreateFileStream("overhead-report.txt");
+  ndn::KiteOverheadTracer::PrintReport(*overheadStream->GetStream());
+
   Simulator::Destroy();
 
   return 0;
@@ -17,13 +17,37 @@
 
 #include "push-producer.h"
 #include "push-consumer.h"
+#include "kite-state-tracer.h"
+#include "kite-overhead-tracer.h"
+#include "kite-path-stretch-tracer.h"
+#include "kite-background-traffic.h"
 
 #include "fw/kite-trace-strategy.hpp"
+#include "kite-shortcut-strategy.h"
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE("ndn.kite.SimplePush");
 
+static void
+MessageDelivered(Ptr<OutputStreamWrapper> stream, uint32_t seq, Time latency)
+{
+  *stream->GetStream() << Simulator::Now().ToDouble(Time::S) << "\t" << seq << "\t"
+                       << latency.ToDouble(Time::S) << std::endl;
+}
+
+static void
+QueueDepth(Ptr<OutputStreamWrapper> stream, uint32_t oldDepth, uint32_t newDepth)
+{
+  *stream->GetStream() << Simulator::Now().ToDouble(Time::S) << "\tDepth\t" << newDepth << std::endl;
+}
+
+static void
+WaitingTime(Ptr<OutputStreamWrapper> stream, Time waitingTime)
+{
+  *stream->GetStream() << Simulator::Now().ToDouble(Time::S) << "\tWaiting\t" << waitingTime.ToDouble(Time::S) << std::endl;
+}
+
 int
 main(int argc, char* argv[])
 {
@@ -35,6 +59,7 @@ main(int argc, char* argv[])
   // LogComponentEnable("ndn.kite.KiteUploadMobile", LOG_LEVEL_INFO);
 
   // LogComponentEnable("nfd.TraceTable", LOG_LEVEL_INFO);
+  // LogComponentEnable("nfd.KiteShortcutStrategy", LOG_LEVEL_INFO);
 
   // setting default parameters for PointToPoint links and channels
   Config::SetDefault("ns3::PointToPointNetDevice::DataRate", StringValue("1Mbps"));
@@ -48,6 +73,16 @@ main(int argc, char* argv[])
   int speed = 100;        //100
   int stopTime = 100;
   int joinTime = 1;
+  bool multiAnchor = false;
+  double publishRate = 0;
+  uint32_t window = 4;
+  uint32_t batchSize = 1;
+  uint32_t workers = 0;
+  double serviceTime = 0.001;
+  bool shortcut = false;
+  uint32_t background = 0;
+  double load = 0.7;
+  bool bursty = false;
 
   // Read optional command-line parameters (e.g., enable visualizer with ./waf --run=<> --visualize
   CommandLine cmd;
@@ -57,8 +92,23 @@ main(int argc, char* argv[])
   cmd.AddValue("grid", "grid size", gridSize);  
   cmd.AddValue("stop", "stop time", stopTime);  
   cmd.AddValue("join", "join period", joinTime); 
+  cmd.AddValue("multianchor", "let the mobile choose between anchors at node 0 and node 3", multiAnchor);
+  cmd.AddValue("rate", "messages published per second, 0 for periodic notifications", publishRate);
+  cmd.AddValue("window", "outstanding fetch Interests of the mobile", window);
+  cmd.AddValue("batch", "messages coalesced into one Data", batchSize);
+  cmd.AddValue("workers", "requests the server handles in parallel, 0 for infinite capacity", workers);
+  cmd.AddValue("service", "mean service time of one request at the server, in seconds", serviceTime);
+  cmd.AddValue("shortcut", "send tracing Interests down a trace already known to the router, without visiting the anchor", shortcut);
+  cmd.AddValue("background", "# background consumer/producer pairs across the backbone, 0 for none", background);
+  cmd.AddValue("load", "share of the capacity of every backbone link the background pairs use together", load);
+  cmd.AddValue("bursty", "send background traffic in exponential on/off bursts instead of at a constant rate", bursty);
   cmd.Parse(argc, argv);
 
+  std::stringstream serviceTimeStream;
+  serviceTimeStream << "ns3::ExponentialRandomVariable[Mean=" << serviceTime << "]";
+  Config::SetDefault("ns3::ndn::KiteServiceQueue::Workers", UintegerValue(workers));
+  Config::SetDefault("ns3::ndn::KiteServiceQueue::ServiceTime", StringValue(serviceTimeStream.str()));
+
   // Creating nodes
   NodeContainer nodes;
   nodes.Create(6);
@@ -146,7 +196,10 @@ main(int argc, char* argv[])
   // Choosing forwarding strategy
   //ndn::StrategyChoiceHelper::Install(nodes.Get(0), "/", "/localhost/nfd/strategy/kite-trace");
   //ndn::StrategyChoiceHelper::InstallAll("/", "/localhost/nfd/strategy/kite-trace");
-  ndn::StrategyChoiceHelper::InstallAll<nfd::fw::KiteTraceStrategy>("/");
+  if (shortcut)
+    ndn::StrategyChoiceHelper::InstallAll<nfd::fw::KiteShortcutStrategy>("/");
+  else
+    ndn::StrategyChoiceHelper::InstallAll<nfd::fw::KiteTraceStrategy>("/");
   //ndn::StrategyChoiceHelper::InstallAll<nfd::fw::KiteTraceStrategy>("/");
 
   std::string serverPrefix = "/server";
@@ -168,27 +221,89 @@ main(int argc, char* argv[])
   ndn::FibHelper::AddRoute (nodes.Get(1), serverPrefix, nodes.Get(2), 1);
 
 
+  // Second anchor next to the access points, the mobile picks the closer one
+  std::string nearAnchorPrefix = "/near-anchor";
+  if (multiAnchor) {
+    ndn::FibHelper::AddRoute (nodes.Get(0), nearAnchorPrefix, nodes.Get(1), 1);
+    ndn::FibHelper::AddRoute (nodes.Get(1), nearAnchorPrefix, nodes.Get(3), 1);
+    ndn::FibHelper::AddRoute (nodes.Get(2), nearAnchorPrefix, nodes.Get(1), 1);
+    ndn::FibHelper::AddRoute (nodes.Get(4), nearAnchorPrefix, nodes.Get(3), 1);
+    ndn::FibHelper::AddRoute (nodes.Get(5), nearAnchorPrefix, nodes.Get(3), 1);
+
+    // Anchors answer RTT probes
+    ndn::AppHelper probeHelper("ns3::ndn::Producer");
+    probeHelper.SetAttribute("PayloadSize", StringValue("16"));
+    probeHelper.SetPrefix(anchorPrefix + "/probe");
+    probeHelper.Install(nodes.Get(0));
+    probeHelper.SetPrefix(nearAnchorPrefix + "/probe");
+    probeHelper.Install(nodes.Get(3));
+  }
+
   // Installing applications
   // Stationary server
   ndn::AppHelper serverHelper("ns3::ndn::KitePushProducer");
   serverHelper.SetPrefix(serverPrefix);                    
-  serverHelper.SetAttribute("TraceNamePrefix", StringValue(anchorPrefix + mobilePrefix));
-  // ServerPrefix of Server app will send at Start-time.  
-  serverHelper.SetAttribute("ServerPrefix", StringValue(anchorPrefix + serverPrefix + mobilePrefix)); 
+  if (multiAnchor) {
+    // ServerPrefix is relative to the anchor announced by the mobile
+    serverHelper.SetAttribute("ServerPrefix", StringValue(serverPrefix + mobilePrefix));
+    serverHelper.SetAttribute("FollowAnchor", BooleanValue(true));
+  }
+  else {
+    serverHelper.SetAttribute("TraceNamePrefix", StringValue(anchorPrefix + mobilePrefix));
+    // ServerPrefix of Server app will send at Start-time.  
+    serverHelper.SetAttribute("ServerPrefix", StringValue(anchorPrefix + serverPrefix + mobilePrefix)); 
+  }
   serverHelper.SetAttribute("PayloadSize", StringValue("1024"));
+  serverHelper.SetAttribute("PublishRate", DoubleValue(publishRate));
   ApplicationContainer producerApp = serverHelper.Install(nodes.Get(2));                        // producer node
   producerApp.Start(Seconds(1));
 
 
   // Mobile node
   ndn::AppHelper mobileNodeHelper("ns3::ndn::KitePushConsumer");
+  mobileNodeHelper.SetPrefix(mobilePrefix);
 
   mobileNodeHelper.SetAttribute("AnchorPrefix", StringValue(anchorPrefix + mobilePrefix));
+  if (multiAnchor) {
+    mobileNodeHelper.SetAttribute("AnchorPrefixes", StringValue(anchorPrefix + " " + nearAnchorPrefix));
+  }
   mobileNodeHelper.SetAttribute("ServerPrefix", StringValue(serverPrefix + mobilePrefix + anchorPrefix));
+  mobileNodeHelper.SetAttribute("Window", UintegerValue(window));
+  mobileNodeHelper.SetAttribute("BatchSize", UintegerValue(batchSize));
   mobileNodeHelper.Install(mobileNodes.Get(0)); // mobile producer node
 
+  // Delivery latency of pushed messages
+  AsciiTraceHelper asciiTraceHelper;
+  Ptr<OutputStreamWrapper> latencyStream = asciiTraceHelper.CreateFileStream("push-latency.txt");
+  *latencyStream->GetStream() << "Time\tSeq\tLatency" << std::endl;
+  Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/$ns3::ndn::KitePushConsumer/MessageDelivered",
+                                MakeBoundCallback(&MessageDelivered, latencyStream));
+
+  // Queueing at the server, with --workers set
+  if (workers > 0) {
+    Ptr<OutputStreamWrapper> serviceStream = asciiTraceHelper.CreateFileStream("service-queue.txt");
+    *serviceStream->GetStream() << "Time\tType\tValue" << std::endl;
+    Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/$ns3::ndn::KitePushProducer/ServiceQueue/QueueDepth",
+                                  MakeBoundCallback(&QueueDepth, serviceStream));
+    Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/$ns3::ndn::KitePushProducer/ServiceQueue/WaitingTime",
+                                  MakeBoundCallback(&WaitingTime, serviceStream));
+  }
+
   L2RateTracer::InstallAll("drop-trace.txt", Seconds(5.0));
   ndn::L3RateTracer::InstallAll("rate-trace.txt", Seconds(5.0));
+  ndn::KiteStateTracer::InstallAll("state-trace.txt", Seconds(5.0));
+  ndn::KiteOverheadTracer::InstallAll("overhead-trace.txt", Seconds(5.0));
+  ndn::KitePathStretchTracer::InstallAll("path-stretch.txt", Seconds(1.0));
+
+  // Background load on the backbone, with --background set (after the tracers: its Data is not payload)
+  if (background > 0) {
+    ndn::KiteBackgroundTraffic backgroundTraffic;
+    backgroundTraffic.SetLoad(load);
+    if (bursty) {
+      backgroundTraffic.SetBursty(Seconds(0.5), Seconds(0.5));
+    }
+    backgroundTraffic.InstallAcross(nodes, background);
+  }
 
   Simulator::Stop(Seconds(20.0));
 
@@ -196,6 +311,11 @@ main(int argc, char* argv[])
   ndn::L3RateTracer::InstallAll("rate-trace.txt", Seconds(0.5));
 
   Simulator::Run();
+
+  // Control bytes per delivered payload byte over the whole run
+  Ptr<OutputStreamWrapper> overheadStream = asciiTraceHelper.CreateFileStream("overhead-report.txt");
+  ndn::KiteOverheadTracer::PrintReport(*overheadStream->GetStream());
+
   Simulator::Destroy();
 
   return 0;
@@ -18,6 +18,13 @@
 
 #include "ndn-kite-upload-server.h"
 #include "ndn-kite-upload-mobile.h"
+#include "kite-state-tracer.h"
+#include "kite-overhead-tracer.h"
+#include "kite-latency-tracer.h"
+#include "kite-delay-tracer.h"
+#include "kite-workload-recorder.h"
+#include "kite-load-generator.h"
+#include "kite-background-traffic.h"
 
 #include "fw/kite-trace-strategy.hpp"
 
@@ -25,6 +32,57 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE("ndn.kite.WifiUpload");
 
+static void
+QueueDepth(Ptr<OutputStreamWrapper> stream, uint32_t oldDepth, uint32_t newDepth)
+{
+  *stream->GetStream() << Simulator::Now().ToDouble(Time::S) << "\tDepth\t" << newDepth << std::endl;
+}
+
+static void
+WaitingTime(Ptr<OutputStreamWrapper> stream, Time waitingTime)
+{
+  *stream->GetStream() << Simulator::Now().ToDouble(Time::S) << "\tWaiting\t" << waitingTime.ToDouble(Time::S) << std::endl;
+}
+
+static std::map<uint32_t, uint64_t> g_shardBytes; // server node -> received bytes
+
+static void
+ShardReceivedData(shared_ptr<const ndn::Data> data, Ptr<ndn::App> app, shared_ptr<ndn::Face> face)
+{
+  g_shardBytes[app->GetNode()->GetId()] += data->getContent().value_size();
+}
+
+static std::map<ndn::Name, std::pair<uint64_t, uint64_t>> g_admission; // mobile -> admitted, rejected requests
+
+static void
+RequestAdmission(const ndn::Name& mobilePrefix, bool admitted)
+{
+  // every flooding prefix is counted under /flood
+  ndn::Name mobile = ndn::Name("/flood").isPrefixOf(mobilePrefix) ? ndn::Name("/flood") : mobilePrefix;
+  if (admitted)
+    g_admission[mobile].first++;
+  else
+    g_admission[mobile].second++;
+}
+
+/**
+ * @brief Route prefix towards grid node (row, col), first along the rows then along the columns
+ */
+static void
+AddGridRoutes(PointToPointGridHelper& grid, int gridSize, const std::string& prefix, int row, int col)
+{
+  for (int i = 0; i<gridSize; i++)
+  {
+    for (int j = 0; j<gridSize; j++)
+    {
+        if (i == row && j == col) continue;
+        int m = i != row ? (i < row ? i + 1 : i - 1) : i;
+        int n = i != row ? j : (j < col ? j + 1 : j - 1);
+        ndn::FibHelper::AddRoute (grid.GetNode (i, j), prefix, grid.GetNode (m, n), 1);
+    }
+  }
+}
+
 int
 main(int argc, char* argv[])
 {
@@ -48,6 +106,21 @@ main(int argc, char* argv[])
   int speed = 60;        //100
   int stopTime = 100;
   int joinTime = 1;
+  uint32_t segments = 0;
+  bool useManifest = false;
+  uint32_t shards = 0;
+  double flood = 0;
+  uint32_t secret = 0;
+  double requestRate = 0;
+  uint32_t maxPending = 0;
+  uint32_t workers = 0;
+  double serviceTime = 0.001;
+  std::string weights;
+  bool record = false;
+  bool histograms = false;
+  uint32_t background = 0;
+  double load = 0.7;
+  bool bursty = false;
 
   // Read optional command-line parameters (e.g., enable visualizer with ./waf --run=<> --visualize
   CommandLine cmd;
@@ -57,8 +130,28 @@ main(int argc, char* argv[])
   cmd.AddValue("grid", "grid size", gridSize);  
   cmd.AddValue("stop", "stop time", stopTime);  
   cmd.AddValue("join", "join period", joinTime); 
+  cmd.AddValue("segments", "# segments of a bulk upload, 0 for an endless stream", segments);
+  cmd.AddValue("manifest", "publish a manifest before the segments of a bulk upload", useManifest);
+  cmd.AddValue("shards", "# upload servers sharing the mobiles by name hash, 0 for a single server", shards);
+  cmd.AddValue("flood", "upload requests/s of a node flooding the server, 0 for none", flood);
+  cmd.AddValue("secret", "secret the server and the mobiles derive request tokens from, 0 for no tokens", secret);
+  cmd.AddValue("rate", "upload requests/s the server admits from every mobile, 0 for no limit", requestRate);
+  cmd.AddValue("pending", "outstanding tracing Interests of the server, 0 for no limit", maxPending);
+  cmd.AddValue("weights", "bulk upload weights of the server, as <mobile prefix>:<weight> pairs", weights);
+  cmd.AddValue("workers", "requests the server handles in parallel, 0 for infinite capacity", workers);
+  cmd.AddValue("service", "mean service time of one request at the server, in seconds", serviceTime);
+  cmd.AddValue("record", "record the packets of the applications into workload.bin, see replay-workload", record);
+  cmd.AddValue("histograms", "write delay percentiles per second instead of one row per Data", histograms);
+  cmd.AddValue("background", "# background consumer/producer pairs across the backbone, 0 for none", background);
+  cmd.AddValue("load", "share of the capacity of every backbone link the background pairs use together", load);
+  cmd.AddValue("bursty", "send background traffic in exponential on/off bursts instead of at a constant rate", bursty);
   cmd.Parse(argc, argv);
 
+  std::stringstream serviceTimeStream;
+  serviceTimeStream << "ns3::ExponentialRandomVariable[Mean=" << serviceTime << "]";
+  Config::SetDefault("ns3::ndn::KiteServiceQueue::Workers", UintegerValue(workers));
+  Config::SetDefault("ns3::ndn::KiteServiceQueue::ServiceTime", StringValue(serviceTimeStream.str()));
+
   // Creating nodes
   PointToPointHelper p2p;
   PointToPointGridHelper grid (gridSize, gridSize, p2p);
@@ -135,41 +228,188 @@ main(int argc, char* argv[])
   std::string serverPrefix = "/server";
   std::string mobilePrefix = "/mobile";
 
-  
-  for (int i = 0; i<gridSize; i++)
-  {
-    for (int j = 0; j<gridSize; j++)
+  if (shards == 0) {
+    for (int i = 0; i<gridSize; i++)
     {
-        //ndnHelper.Install (grid.GetNode (i, j));
-        if (i ==0 && j==0) continue;
-        int m = i>j ? (i - 1) : i;
-        int n = i>j ? j : (j - 1);
-        ndn::FibHelper::AddRoute (grid.GetNode (i, j), serverPrefix, grid.GetNode (m, n), 1);
+      for (int j = 0; j<gridSize; j++)
+      {
+          //ndnHelper.Install (grid.GetNode (i, j));
+          if (i ==0 && j==0) continue;
+          int m = i>j ? (i - 1) : i;
+          int n = i>j ? j : (j - 1);
+          ndn::FibHelper::AddRoute (grid.GetNode (i, j), serverPrefix, grid.GetNode (m, n), 1);
+      }
+    }
+
+    // Installing applications
+    // Stationary server
+    ndn::AppHelper serverHelper("ns3::ndn::KiteUploadServer");
+    serverHelper.SetPrefix(mobilePrefix);
+    serverHelper.SetAttribute("ServerPrefix", StringValue(serverPrefix));
+    serverHelper.SetAttribute("TokenSecret", UintegerValue(secret));
+    serverHelper.SetAttribute("RequestRate", DoubleValue(requestRate));
+    serverHelper.SetAttribute("MaxPending", UintegerValue(maxPending));
+    serverHelper.SetAttribute("Weights", StringValue(weights));
+    serverHelper.Install(grid.GetNode(0, 0));                        // first node
+
+    // Mobile nodes, each under its own prefix when there are several
+    for (uint32_t i = 0; i < mobileNodes.GetN(); i++) {
+      std::string prefix = mobileNodes.GetN() > 1 ? mobilePrefix + std::to_string(i) : mobilePrefix;
+
+      ndn::AppHelper mobileNodeHelper("ns3::ndn::KiteUploadMobile");
+      mobileNodeHelper.SetPrefix(prefix);
+      mobileNodeHelper.SetAttribute("ServerPrefix", StringValue(serverPrefix));
+      mobileNodeHelper.SetAttribute("MobilePrefix", StringValue(prefix));
+      mobileNodeHelper.SetAttribute("PayloadSize", StringValue("1024"));
+      mobileNodeHelper.SetAttribute("ObjectSize", UintegerValue(segments));
+      mobileNodeHelper.SetAttribute("Manifest", BooleanValue(useManifest));
+      mobileNodeHelper.SetAttribute("RequestSecret", UintegerValue(secret));
+      mobileNodeHelper.Install(mobileNodes.Get(i));
+    }
+
+    if (flood > 0) {
+      // Stationary node in the far corner sending upload requests without knowing the secret,
+      // under more spoofed prefixes /flood/<i> than the server keeps token buckets for
+      uint32_t floodPrefixes = 4096;
+      ndn::AppHelper floodHelper("ns3::ndn::KiteLoadGenerator");
+      floodHelper.SetAttribute("ServerPrefix", StringValue(serverPrefix));
+      floodHelper.SetAttribute("MobilePrefix", StringValue("/flood"));
+      floodHelper.SetAttribute("MobileCount", UintegerValue(floodPrefixes));
+      floodHelper.SetAttribute("PayloadSize", UintegerValue(1024));
+      floodHelper.SetAttribute("TraceInterval", TimeValue(Seconds(floodPrefixes / flood)));
+      floodHelper.Install(grid.GetNode(gridSize - 1, gridSize - 1));
     }
+
+    Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/$ns3::ndn::KiteUploadServer/RequestAdmission",
+                                  MakeCallback(&RequestAdmission));
   }
+  else {
+    // Sharded servers spread over the grid, each owning /server/<shard>
+    for (uint32_t k = 0; k < shards; k++) {
+      int position = k * gridSize * gridSize / shards;
+      int row = position / gridSize;
+      int col = position % gridSize;
+
+      std::string shardPrefix = serverPrefix + "/" + std::to_string(k);
+      AddGridRoutes(grid, gridSize, shardPrefix, row, col);
+
+      ndn::AppHelper serverHelper("ns3::ndn::KiteUploadServer");
+      serverHelper.SetPrefix(mobilePrefix);
+      serverHelper.SetAttribute("ServerPrefix", StringValue(serverPrefix));
+      serverHelper.SetAttribute("ShardCount", UintegerValue(shards));
+      serverHelper.SetAttribute("ShardIndex", UintegerValue(k));
+      serverHelper.SetAttribute("Weights", StringValue(weights));
+      serverHelper.Install(grid.GetNode(row, col));
+    }
+
+    // Every mobile uploads under its own prefix, so that mobiles spread over the shards
+    for (uint32_t i = 0; i < mobileNodes.GetN(); i++) {
+      std::string prefix = mobilePrefix + std::to_string(i);
+
+      ndn::AppHelper mobileNodeHelper("ns3::ndn::KiteUploadMobile");
+      mobileNodeHelper.SetPrefix(prefix);
+      mobileNodeHelper.SetAttribute("ServerPrefix", StringValue(serverPrefix));
+      mobileNodeHelper.SetAttribute("MobilePrefix", StringValue(prefix));
+      mobileNodeHelper.SetAttribute("PayloadSize", StringValue("1024"));
+      mobileNodeHelper.SetAttribute("ObjectSize", UintegerValue(segments));
+      mobileNodeHelper.SetAttribute("Manifest", BooleanValue(useManifest));
+      mobileNodeHelper.SetAttribute("ShardCount", UintegerValue(shards));
+      mobileNodeHelper.Install(mobileNodes.Get(i));
+    }
 
-  // Installing applications
-  // Stationary server
-  ndn::AppHelper serverHelper("ns3::ndn::KiteUploadServer");
-  serverHelper.SetPrefix(mobilePrefix);
-  serverHelper.SetAttribute("ServerPrefix", StringValue(serverPrefix));
-  serverHelper.Install(grid.GetNode(0, 0));                        // first node
-
-  // Mobile node
-  ndn::AppHelper mobileNodeHelper("ns3::ndn::KiteUploadMobile");
-  mobileNodeHelper.SetPrefix(mobilePrefix);
-  mobileNodeHelper.SetAttribute("ServerPrefix", StringValue(serverPrefix));
-  mobileNodeHelper.SetAttribute("MobilePrefix", StringValue(mobilePrefix));
-  mobileNodeHelper.SetAttribute("PayloadSize", StringValue("1024"));
-  mobileNodeHelper.Install(mobileNodes.Get(0)); // last node
+    Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/$ns3::ndn::KiteUploadServer/ReceivedDatas",
+                                  MakeCallback(&ShardReceivedData));
+  }
+
+  AsciiTraceHelper asciiTraceHelper;
+
+  // Completion time and goodput of bulk uploads
+  ndn::KiteUploadServer::TraceCompletions("upload-completion.txt");
+
+  // Queueing at the server, with --workers set
+  if (workers > 0) {
+    Ptr<OutputStreamWrapper> serviceStream = asciiTraceHelper.CreateFileStream("service-queue.txt");
+    *serviceStream->GetStream() << "Time\tType\tValue" << std::endl;
+    Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/$ns3::ndn::KiteUploadServer/ServiceQueue/QueueDepth",
+                                  MakeBoundCallback(&QueueDepth, serviceStream));
+    Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/$ns3::ndn::KiteUploadServer/ServiceQueue/WaitingTime",
+                                  MakeBoundCallback(&WaitingTime, serviceStream));
+  }
 
   L2RateTracer::InstallAll("drop-trace.txt", Seconds(5));
   ndn::L3RateTracer::InstallAll("rate-trace.txt", Seconds(5));
-  ndn::AppDelayTracer::InstallAll("app-delays-trace.txt");
+  if (record) {
+    ndn::KiteWorkloadRecorder::InstallAll("workload.bin");
+  }
+  ndn::KiteStateTracer::InstallAll("state-trace.txt", Seconds(5));
+  ndn::KiteOverheadTracer::InstallAll("overhead-trace.txt", Seconds(5));
+  if (histograms) {
+    ndn::KiteDelayTracer::InstallAll("app-delays-histogram.txt", Seconds(1));
+  }
+  else {
+    ndn::AppDelayTracer::InstallAll("app-delays-trace.txt");
+  }
+  ndn::KiteLatencyTracer::InstallAll("upload-latency.txt", "upload-hops.txt");
+
+  // Background load on the grid, with --background set (after the tracers: its Data is not payload)
+  if (background > 0) {
+    NodeContainer backbone;
+    for (int i = 0; i < gridSize; i++) {
+      for (int j = 0; j < gridSize; j++) {
+        backbone.Add(grid.GetNode(i, j));
+      }
+    }
+
+    ndn::KiteBackgroundTraffic backgroundTraffic;
+    backgroundTraffic.SetLoad(load);
+    if (bursty) {
+      backgroundTraffic.SetBursty(Seconds(0.5), Seconds(0.5));
+    }
+    backgroundTraffic.InstallAcross(backbone, background);
+  }
 
   Simulator::Stop(Seconds(100.0));
 
   Simulator::Run();
+
+  // Control bytes per delivered payload byte over the whole run
+  Ptr<OutputStreamWrapper> overheadStream = asciiTraceHelper.CreateFileStream("overhead-report.txt");
+  ndn::KiteOverheadTracer::PrintReport(*overheadStream->GetStream());
+
+  // Throughput of every bulk upload and fairness among them
+  if (segments > 0) {
+    Ptr<OutputStreamWrapper> fairnessStream = asciiTraceHelper.CreateFileStream("upload-fairness.txt");
+    *fairnessStream->GetStream() << "Node\tMobile\tWeight\tBytes\tThroughput" << std::endl;
+    for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
+      for (uint32_t i = 0; i < (*node)->GetNApplications(); i++) {
+        Ptr<ndn::KiteUploadServer> server = DynamicCast<ndn::KiteUploadServer>((*node)->GetApplication(i));
+        if (server != 0) {
+          server->ReportFairness(*fairnessStream->GetStream());
+        }
+      }
+    }
+  }
+
+  // Upload capacity of every shard
+  if (shards > 0) {
+    Ptr<OutputStreamWrapper> shardStream = asciiTraceHelper.CreateFileStream("shard-throughput.txt");
+    *shardStream->GetStream() << "Node\tBytes\tThroughput" << std::endl;
+    for (const auto& shard : g_shardBytes) {
+      *shardStream->GetStream() << shard.first << "\t" << shard.second << "\t"
+                                << (shard.second * 8 / Simulator::Now().ToDouble(Time::S) / 1000) << std::endl;
+    }
+  }
+
+  // Upload requests admitted and rejected by the server, per mobile
+  if (!g_admission.empty()) {
+    Ptr<OutputStreamWrapper> admissionStream = asciiTraceHelper.CreateFileStream("upload-admission.txt");
+    *admissionStream->GetStream() << "Mobile\tAdmitted\tRejected" << std::endl;
+    for (const auto& mobile : g_admission) {
+      *admissionStream->GetStream() << mobile.first << "\t" << mobile.second.first << "\t"
+                                    << mobile.second.second << std::endl;
+    }
+  }
+
   Simulator::Destroy();
 
   return 0;
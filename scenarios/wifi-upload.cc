@@ -17,13 +17,29 @@
 
 #include "ndn-kite-upload-server.h"
 #include "ndn-kite-upload-mobile.h"
+#include "kite-handoff-tracer.h"
+#include "kite-state-tracer.h"
+#include "kite-overhead-tracer.h"
+#include "kite-latency-tracer.h"
+#include "kite-delay-tracer.h"
+#include "kite-workload-recorder.h"
 
 #include "fw/kite-trace-strategy.hpp"
+#include "kite-shortcut-strategy.h"
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE("ndn.kite.WifiUpload");
 
+static void
+PathCompleted(Ptr<OutputStreamWrapper> stream, const ndn::Name& mobilePrefix, uint32_t path,
+              uint64_t bytes, Time completionTime)
+{
+  *stream->GetStream() << Simulator::Now().ToDouble(Time::S) << "\t" << mobilePrefix << "\t"
+                       << path << "\t" << bytes << "\t"
+                       << (bytes * 8 / completionTime.ToDouble(Time::S) / 1000) << std::endl;
+}
+
 int
 main(int argc, char* argv[])
 {
@@ -47,6 +63,13 @@ main(int argc, char* argv[])
   int speed = 100;        //100
   int stopTime = 100;
   int joinTime = 1;
+  uint32_t segments = 0;
+  bool useManifest = false;
+  uint32_t paths = 1;
+  bool predict = false;
+  bool record = false;
+  bool histograms = false;
+  bool piggyback = false;
 
   // Read optional command-line parameters (e.g., enable visualizer with ./waf --run=<> --visualize
   CommandLine cmd;
@@ -56,6 +79,13 @@ main(int argc, char* argv[])
   cmd.AddValue("grid", "grid size", gridSize);  
   cmd.AddValue("stop", "stop time", stopTime);  
   cmd.AddValue("join", "join period", joinTime); 
+  cmd.AddValue("segments", "# segments of a bulk upload, 0 for an endless stream", segments);
+  cmd.AddValue("manifest", "publish a manifest before the segments of a bulk upload", useManifest);
+  cmd.AddValue("predict", "set up the trace through the next access point as soon as it is reached", predict);
+  cmd.AddValue("paths", "# radios of the mobile, 2 to upload through both access points at once", paths);
+  cmd.AddValue("record", "record the packets of the applications into workload.bin, see replay-workload", record);
+  cmd.AddValue("histograms", "write delay percentiles per second instead of one row per Data", histograms);
+  cmd.AddValue("piggyback", "refresh the trace with the Data of a bulk upload, requests are only sent when idle", piggyback);
   cmd.Parse(argc, argv);
 
   // Creating nodes
@@ -130,9 +160,20 @@ main(int argc, char* argv[])
   wifiChannel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
   wifiChannel.AddPropagationLoss ("ns3::LogDistancePropagationLossModel", "Exponent", DoubleValue (3));
   wifiPhy.SetChannel (wifiChannel.Create ());
-  wifi.Install (wifiPhy, wifiMac, mobileNodes);
-  wifi.Install (wifiPhy, wifiMac, nodes.Get(2));
-  wifi.Install (wifiPhy, wifiMac, nodes.Get(3));
+  if (paths > 1) {
+    // one channel per access point, the mobile has a radio on each
+    YansWifiPhyHelper secondWifiPhy = wifiPhy;
+    secondWifiPhy.SetChannel (wifiChannel.Create ());
+    wifi.Install (wifiPhy, wifiMac, mobileNodes);
+    wifi.Install (secondWifiPhy, wifiMac, mobileNodes);
+    wifi.Install (wifiPhy, wifiMac, nodes.Get(2));
+    wifi.Install (secondWifiPhy, wifiMac, nodes.Get(3));
+  }
+  else {
+    wifi.Install (wifiPhy, wifiMac, mobileNodes);
+    wifi.Install (wifiPhy, wifiMac, nodes.Get(2));
+    wifi.Install (wifiPhy, wifiMac, nodes.Get(3));
+  }
 
   ndn::StackHelper ndnHelper;
   ndnHelper.SetDefaultRoutes(true);
@@ -141,7 +182,10 @@ main(int argc, char* argv[])
   // Choosing forwarding strategy
   //ndn::StrategyChoiceHelper::Install(nodes.Get(0), "/", "/localhost/nfd/strategy/kite-trace");
   //ndn::StrategyChoiceHelper::InstallAll("/", "/localhost/nfd/strategy/kite-trace");
-  ndn::StrategyChoiceHelper::InstallAll<nfd::fw::KiteTraceStrategy>("/");
+  if (piggyback) // routers have to understand the refresh marker
+    ndn::StrategyChoiceHelper::InstallAll<nfd::fw::KiteShortcutStrategy>("/");
+  else
+    ndn::StrategyChoiceHelper::InstallAll<nfd::fw::KiteTraceStrategy>("/");
   //ndn::StrategyChoiceHelper::InstallAll<nfd::fw::KiteTraceStrategy>("/");
 
   std::string serverPrefix = "/server";
@@ -162,15 +206,56 @@ main(int argc, char* argv[])
   mobileNodeHelper.SetAttribute("ServerPrefix", StringValue(serverPrefix));
   mobileNodeHelper.SetAttribute("MobilePrefix", StringValue(mobilePrefix));
   mobileNodeHelper.SetAttribute("PayloadSize", StringValue("1024"));
+  mobileNodeHelper.SetAttribute("ObjectSize", UintegerValue(segments));
+  mobileNodeHelper.SetAttribute("Manifest", BooleanValue(useManifest));
+  mobileNodeHelper.SetAttribute("PathCount", UintegerValue(paths));
+  mobileNodeHelper.SetAttribute("PiggybackRefresh", BooleanValue(piggyback));
+  if (predict) {
+    Config::SetDefault("ns3::ndn::KiteHandoffPredictor::AccessPoints", StringValue("200:100 200:-100")); // positions of the wifi-enabled routers
+  }
   mobileNodeHelper.Install(mobileNodes.Get(0)); // last node
 
+  // Measure outage after every change of access point
+  NodeContainer accessPoints;
+  accessPoints.Add(nodes.Get(2));
+  accessPoints.Add(nodes.Get(3));
+  ndn::KiteHandoffTracer::Install(mobileNodes.Get(0), accessPoints, nodes.Get(0),
+                                  "handoff-trace.txt", "handoff-histogram.txt");
+
+  AsciiTraceHelper asciiTraceHelper;
+
+  // Completion time and goodput of bulk uploads
+  ndn::KiteUploadServer::TraceCompletions("upload-completion.txt");
+
+  // Goodput of every path of multipath bulk uploads
+  Ptr<OutputStreamWrapper> pathStream = asciiTraceHelper.CreateFileStream("upload-paths.txt");
+  *pathStream->GetStream() << "Time\tMobile\tPath\tBytes\tGoodput" << std::endl;
+  Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/$ns3::ndn::KiteUploadServer/PathCompleted",
+                                MakeBoundCallback(&PathCompleted, pathStream));
+
   L2RateTracer::InstallAll("drop-trace.txt", Seconds(0.5));
   ndn::L3RateTracer::InstallAll("rate-trace.txt", Seconds(0.5));
-  ndn::AppDelayTracer::InstallAll("app-delays-trace.txt");
+  if (record) {
+    ndn::KiteWorkloadRecorder::InstallAll("workload.bin");
+  }
+  ndn::KiteStateTracer::InstallAll("state-trace.txt", Seconds(0.5));
+  ndn::KiteOverheadTracer::InstallAll("overhead-trace.txt", Seconds(0.5));
+  if (histograms) {
+    ndn::KiteDelayTracer::InstallAll("app-delays-histogram.txt", Seconds(1));
+  }
+  else {
+    ndn::AppDelayTracer::InstallAll("app-delays-trace.txt");
+  }
+  ndn::KiteLatencyTracer::InstallAll("upload-latency.txt", "upload-hops.txt");
 
   Simulator::Stop(Seconds(20.0));
 
   Simulator::Run();
+
+  // Control bytes per delivered payload byte over the whole run
+  Ptr<OutputStreamWrapper> overheadStream = asciiTraceHelper.CreateFileStream("overhead-report.txt");
+  ndn::KiteOverheadTracer::PrintReport(*overheadStream->GetStream());
+
   Simulator::Destroy();
 
   return 0;